@@ -5,6 +5,9 @@
 #include <cstdlib>
 #include <iterator>
 #include <assert.h>
+#if __has_include(<bit>)
+#include <bit>
+#endif
 
 namespace OP::common
 {
@@ -22,7 +25,10 @@ namespace OP::common
     */
     constexpr inline std::uint32_t log2_32(std::uint32_t v) noexcept
     {
-
+#ifdef __cpp_lib_bitops
+        //compiles to single BSR/LZCNT instruction where available
+        return v ? static_cast<std::uint32_t>(std::bit_width(v) - 1) : 0;
+#else
         v |= v >> 1; // first round down to one less than a power of 2 
         v |= v >> 2;
         v |= v >> 4;
@@ -30,14 +36,19 @@ namespace OP::common
         v |= v >> 16;
 
         return details::MultiplyDeBruijnBitPosition[static_cast<std::uint32_t>(v * 0x07C4ACDDU) >> 27];
+#endif //__cpp_lib_bitops
     }
 
     constexpr inline std::uint32_t log2_64(std::uint64_t v) noexcept
     {
+#ifdef __cpp_lib_bitops
+        return v ? static_cast<std::uint32_t>(std::bit_width(v) - 1) : 0;
+#else
         return v > 0x00000000FFFFFFFFull
             ? log2_32(static_cast<std::uint32_t>(v >> 32)) + 32
             : log2_32(static_cast<std::uint32_t>(v))
             ;
+#endif //__cpp_lib_bitops
     }
 
     template <class T>
@@ -57,23 +68,34 @@ namespace OP::common
 
     /**
     *   Origin from http://graphics.stanford.edu/~seander/bithacks.html#ZerosOnRightMultLookup
+    *   Result for `v == 0` is unspecified.
     */
     constexpr inline std::uint32_t count_trailing_zero_32(std::uint32_t v) noexcept
     {
+#ifdef __cpp_lib_bitops
+        //compiles to single BSF/TZCNT instruction where available
+        return static_cast<std::uint32_t>(std::countr_zero(v));
+#else
         constexpr const std::uint8_t MultiplyDeBruijnBitPosition[32] =
         {
             0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
             31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
         };
         return MultiplyDeBruijnBitPosition[static_cast<std::uint32_t>(((v & (~v+1)) * 0x077CB531U)) >> 27];
+#endif //__cpp_lib_bitops
     }
 
+    /** Result for `v == 0` is unspecified. */
     constexpr inline std::uint32_t count_trailing_zero_64(std::uint64_t v) noexcept
     {
+#ifdef __cpp_lib_bitops
+        return static_cast<std::uint32_t>(std::countr_zero(v));
+#else
         return (v & 0x00000000FFFFFFFFul)
             ? count_trailing_zero_32(static_cast<std::uint32_t>(v))
             : count_trailing_zero_32(static_cast<std::uint32_t>(v >> 32)) + 32
             ;
+#endif //__cpp_lib_bitops
     }
     
     /** Estimate power of 2 that in compare with log2 ceil result up */
@@ -100,12 +122,17 @@ namespace OP::common
     */
     constexpr inline std::uint32_t popcount_sideways32(std::uint32_t x) noexcept
     {
+#ifdef __cpp_lib_bitops
+        //compiles to single POPCNT instruction where available
+        return static_cast<std::uint32_t>(std::popcount(x));
+#else
         x = x - ((x >> 1) & 0x55555555ul);
         x = (x & 0x33333333ul) + ((x >> 2) & 0x33333333ul);
         x = (x + (x >> 4)) & 0x0F0F0F0Ful;
         x = x + (x >> 8) & 0x00FF00FFul;
         x = x + (x >> 16) & 0x0000FFFFul;
         return x & 0x3F;
+#endif //__cpp_lib_bitops
     }
 
     /** bit count number for uint64, special thanks to:
@@ -113,6 +140,9 @@ namespace OP::common
     */
     constexpr inline std::uint64_t popcount_sideways64(std::uint64_t x) noexcept
     {
+#ifdef __cpp_lib_bitops
+        return static_cast<std::uint64_t>(std::popcount(x));
+#else
         x = x - ((x >> 1) & 0x5555555555555555ULL);
         x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
         x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
@@ -120,6 +150,7 @@ namespace OP::common
         x = x + (x >> 16);
         x = x + (x >> 32);
         return x & 0x7F;
+#endif //__cpp_lib_bitops
     }
 
     template <size_t N, class Int>
@@ -463,6 +494,53 @@ namespace OP::common
             return static_cast<dim_t>(_count_bits(std::make_index_sequence<N>()));
         }
 
+        /** Rank of bit: count number of set bits strictly below `index`. For set bit `index` it is
+        * dense (zero based) ordinal of this bit among all set bits. 
+        */
+        constexpr inline dim_t rank(dim_t index) const noexcept
+        {
+            assert(index <= bit_length_c);
+            dim_t result = 0;
+            const size_t last = index / bits_c;
+            for (size_t i = 0; i < last; ++i)
+                result += static_cast<dim_t>(popcount(_presence[i]));
+            if (last < N)
+            {
+                Int mask = (Int(1) << (index % bits_c)) - 1;
+                result += static_cast<dim_t>(popcount(_presence[last] & mask));
+            }
+            return result;
+        }
+
+        /** Select: return index of `nth` (zero based) set bit, or `nil_c` if there are less bits set.
+        * Reverse operation for #rank so `select(rank(i)) == i` for any set bit `i`.
+        */
+        constexpr inline dim_t select(dim_t nth) const noexcept
+        {
+            for (size_t i = 0; i < N; ++i)
+            {
+                auto x = _presence[i];
+                auto cnt = static_cast<dim_t>(popcount(x));
+                if (nth < cnt)
+                {
+                    for (; nth; --nth) //drop lowest set bits
+                        x &= x - 1;
+                    return static_cast<dim_t>(count_trailing_zero_64(x) + i * bits_c);
+                }
+                nth -= cnt;
+            }
+            return nil_c;
+        }
+
+        /** Bitwise OR of two containers */
+        constexpr this_t operator | (const this_t& other) const noexcept
+        {
+            this_t result;
+            for (size_t i = 0; i < N; ++i)
+                result._presence[i] = _presence[i] | other._presence[i];
+            return result;
+        }
+
         /**Return index of first bit that is not set*/
         constexpr inline dim_t first_clear() const noexcept
         {
@@ -530,13 +608,18 @@ namespace OP::common
 
     private:
 
-        template <size_t ... Ix>
-        constexpr std::uint64_t _count_bits(std::index_sequence<Ix...>) const noexcept
+        static constexpr std::uint64_t popcount(Int x) noexcept
         {
             if constexpr(sizeof(Int) < 8)
-                return (popcount_sideways32(_presence[Ix]) + ...);
+                return popcount_sideways32(x);
             else
-                return (popcount_sideways64(_presence[Ix]) + ...);
+                return popcount_sideways64(x);
+        }
+
+        template <size_t ... Ix>
+        constexpr std::uint64_t _count_bits(std::index_sequence<Ix...>) const noexcept
+        {
+            return (popcount(_presence[Ix]) + ...);
         }
 
         template <size_t ... Ix>
@@ -0,0 +1,226 @@
+#pragma once
+#ifndef _OP_COMMON_INLINEVECTOR__H_
+#define _OP_COMMON_INLINEVECTOR__H_
+
+#include <cstddef>
+#include <cassert>
+#include <memory>
+#include <algorithm>
+#include <type_traits>
+#include <stdexcept>
+
+namespace OP
+{
+    /** \brief Vector-like container that keeps first `inline_capacity_c` elements inside the object itself.
+    *
+    *   Heap is involved only when size exceeds `inline_capacity_c`, so short sequences are created, copied
+    *   and destroyed without CRT heap allocation. This is useful for objects that are intensively copied by value
+    *   (like iterators) and keep small stack of positions.
+    *   Container supports only trivially copyable elements, this allows relocate items with plain memory copy.
+    *
+    *   \tparam T type of element, must be trivially copyable and default constructible;
+    *   \tparam inline_capacity_c number of elements that are stored without heap allocation.
+    */
+    template <class T, size_t inline_capacity_c>
+    class InlineVector
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "InlineVector supports trivially copyable types only");
+        static_assert(inline_capacity_c > 0, "inline capacity must be positive");
+
+    public:
+        using value_type = T;
+        using size_type = size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using this_t = InlineVector<T, inline_capacity_c>;
+
+        constexpr static size_t inline_capacity = inline_capacity_c;
+
+        InlineVector() noexcept = default;
+
+        InlineVector(const InlineVector& other)
+        {
+            assign(other);
+        }
+
+        InlineVector(InlineVector&& other) noexcept
+        {
+            steal(other);
+        }
+
+        InlineVector& operator = (const InlineVector& other)
+        {
+            if (this != &other)
+            {
+                _size = 0;
+                assign(other);
+            }
+            return *this;
+        }
+
+        InlineVector& operator = (InlineVector&& other) noexcept
+        {
+            if (this != &other)
+            {
+                _heap.reset();
+                _capacity = inline_capacity_c;
+                steal(other);
+            }
+            return *this;
+        }
+
+        size_t size() const noexcept
+        {
+            return _size;
+        }
+
+        bool empty() const noexcept
+        {
+            return _size == 0;
+        }
+
+        /** Number of elements that can be stored without reallocation */
+        size_t capacity() const noexcept
+        {
+            return _capacity;
+        }
+
+        /** Check if elements are stored inside the object (no heap memory is used) */
+        bool is_inline() const noexcept
+        {
+            return !_heap;
+        }
+
+        T* data() noexcept
+        {
+            return _heap ? _heap.get() : _inline;
+        }
+
+        const T* data() const noexcept
+        {
+            return _heap ? _heap.get() : _inline;
+        }
+
+        iterator begin() noexcept { return data(); }
+        iterator end() noexcept { return data() + _size; }
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + _size; }
+
+        T& operator[](size_t index) noexcept
+        {
+            assert(index < _size);
+            return data()[index];
+        }
+
+        const T& operator[](size_t index) const noexcept
+        {
+            assert(index < _size);
+            return data()[index];
+        }
+
+        T& back() noexcept
+        {
+            assert(_size);
+            return data()[_size - 1];
+        }
+
+        const T& back() const noexcept
+        {
+            assert(_size);
+            return data()[_size - 1];
+        }
+
+        void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        /** Construct new element at the end from the arguments `ux...` */
+        template <class ... Ux>
+        T& emplace_back(Ux&& ... ux)
+        {
+            T value(std::forward<Ux>(ux)...); //arguments may refer to this container, so evaluate before relocation
+            if (_size == _capacity)
+                reserve(_capacity * 2);
+            T* result = data() + _size;
+            *result = value;
+            ++_size;
+            return *result;
+        }
+
+        void pop_back() noexcept
+        {
+            assert(_size);
+            --_size;
+        }
+
+        void clear() noexcept
+        {
+            _size = 0;
+        }
+
+        /** Shrink container to `new_size` elements, bigger size is not allowed */
+        void truncate(size_t new_size) noexcept
+        {
+            assert(new_size <= _size);
+            _size = new_size;
+        }
+
+        /** Remove elements in range `[first, last)`
+        * \return iterator following the last removed element
+        */
+        iterator erase(const_iterator first, const_iterator last) noexcept
+        {
+            auto* from = begin() + (first - begin());
+            auto* tail = begin() + (last - begin());
+            std::copy(tail, end(), from);
+            _size -= static_cast<size_t>(last - first);
+            return from;
+        }
+
+        /** Ensure capacity is not less than `new_capacity`, when exceeds inline capacity
+        *   elements are relocated to the heap.
+        */
+        void reserve(size_t new_capacity)
+        {
+            if (new_capacity <= _capacity)
+                return;
+            std::unique_ptr<T[]> buffer(new T[new_capacity]);
+            std::copy(begin(), end(), buffer.get());
+            _heap = std::move(buffer);
+            _capacity = new_capacity;
+        }
+
+    private:
+        void assign(const InlineVector& other)
+        {
+            reserve(other._size);
+            std::copy(other.begin(), other.end(), data());
+            _size = other._size;
+        }
+
+        void steal(InlineVector& other) noexcept
+        {
+            if (other._heap)
+            {
+                _heap = std::move(other._heap);
+                _capacity = other._capacity;
+            }
+            else
+                std::copy(other.begin(), other.end(), _inline);
+            _size = other._size;
+            other._size = 0;
+            other._capacity = inline_capacity_c;
+        }
+
+        T _inline[inline_capacity_c];
+        std::unique_ptr<T[]> _heap;
+        size_t _capacity = inline_capacity_c;
+        size_t _size = 0;
+    };
+
+}//ns:OP
+
+#endif //_OP_COMMON_INLINEVECTOR__H_
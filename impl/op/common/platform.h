@@ -28,6 +28,16 @@
 #define OP_NOEXCEPT noexcept 
 #endif //
 
+/** Hint CPU to load cache line that contains `addr` for the following read, has no effect on the program semantic */
+#if defined(__GNUC__) || defined(__clang__)
+    #define OP_PREFETCH_READ(addr) __builtin_prefetch((addr), 0, 3)
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #include <xmmintrin.h>
+    #define OP_PREFETCH_READ(addr) _mm_prefetch(reinterpret_cast<const char*>(addr), _MM_HINT_T0)
+#else
+    #define OP_PREFETCH_READ(addr) ((void)(addr))
+#endif
+
 #if __cplusplus >= 202002L
     #define OP_CPP20_FEATURES
     #define OP_VIRTUAL_CONSTEXPR constexpr virtual
@@ -0,0 +1,286 @@
+#pragma once
+
+#ifndef _OP_TRIE_BLOBVALUEMANAGER__H_
+#define _OP_TRIE_BLOBVALUEMANAGER__H_
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <memory>
+#include <string>
+
+#include <op/flur/flur.h>
+#include <op/vtm/SegmentManager.h>
+#include <op/vtm/MemoryChunks.h>
+#include <op/vtm/Transactional.h>
+#include <op/vtm/slots/HeapManager.h>
+
+namespace OP::trie
+{
+    /** Persisted reference to the chain of blob chunks. Empty blob has nil `_head` and `_tail` */
+    struct BlobAddress
+    {
+        vtm::FarAddress _head;
+        /** Last chunk of the chain, allows append without walking the chain */
+        vtm::FarAddress _tail;
+        /** Total number of bytes in all chunks */
+        std::uint64_t _size = 0;
+    };
+
+    /** Header of the single heap block of blob, followed by `_capacity` bytes of data */
+    struct BlobChunkHeader
+    {
+        vtm::FarAddress _next;
+        vtm::segment_pos_t _capacity;
+        vtm::segment_pos_t _size;
+    };
+
+    /**
+    *   Storage converter (\sa store_converter::Storage) that persists std::string as the chain of
+    *   heap blocks. Unlike `Storage<std::string>` value is not limited by the segment size: each chunk
+    *   is allocated separately by HeapManagerSlot and may reside in any segment.
+    *
+    *   \tparam chunk_byte_limit - max number of data bytes in the single chunk. Real limit is also
+    *       bounded by quarter of segment size, so chunk always fits to the segment.
+    */
+    template <vtm::segment_pos_t chunk_byte_limit = 0x10000>
+    struct BlobConverter
+    {
+        using type_t = std::string;
+        using storage_type_t = BlobAddress;
+
+        /** Minimal number of data bytes allocated for the new chunk */
+        constexpr static vtm::segment_pos_t min_chunk_c = 64;
+
+        template <class TTopology>
+        static void serialize(TTopology& topology, const type_t& source, storage_type_t& dest)
+        {
+            dest = storage_type_t{};
+            append(topology, dest, source.data(), source.data() + source.size());
+        }
+
+        template <class TTopology>
+        static void reassign(TTopology& topology, const type_t& source, storage_type_t& dest)
+        {
+            destroy(topology, dest);
+            serialize(topology, source, dest);
+        }
+
+        /** Restore whole value as a single string. To avoid copy of big values use Trie::value_chunks */
+        template <class TTopology>
+        static type_t deserialize(TTopology& topology, const storage_type_t& source)
+        {
+            type_t result;
+            result.reserve(static_cast<size_t>(source._size));
+            for_each_chunk(vtm::resolve_segment_manager(topology), source, [&](const vtm::ReadonlyMemoryChunk& chunk) {
+                result.append(chunk.begin(), chunk.end());
+                });
+            return result;
+        }
+
+        template <class TTopology>
+        static void destroy(TTopology& topology, storage_type_t& dest)
+        {
+            auto& segments = vtm::resolve_segment_manager(topology);
+            auto& heap_manager = topology.template slot<vtm::HeapManagerSlot>();
+            for (auto chunk = dest._head; !chunk.is_nil(); )
+            {
+                auto next = vtm::view<BlobChunkHeader>(segments, chunk)->_next;
+                heap_manager.deallocate(chunk);
+                chunk = next;
+            }
+            dest = storage_type_t{};
+        }
+
+        /**
+        *   Append bytes `[begin, end)` to the blob. At first free space of the tail chunk is used, then
+        *   new chunks are allocated. Capacity of new chunk grows with the blob size, so sequence of small
+        *   appends doesn't produce long chain of tiny chunks. Must be called in the transaction scope.
+        */
+        template <class TTopology>
+        static void append(TTopology& topology, storage_type_t& dest, const char* begin, const char* end)
+        {
+            auto& segments = vtm::resolve_segment_manager(topology);
+            if (begin != end && !dest._tail.is_nil())
+            {
+                auto tail = vtm::accessor<BlobChunkHeader>(segments, dest._tail);
+                const auto portion = static_cast<vtm::segment_pos_t>(
+                    std::min<size_t>(tail->_capacity - tail->_size, end - begin));
+                if (portion)
+                {
+                    segments.writable_block(data_of(dest._tail) + tail->_size, portion)
+                        .byte_copy(begin, portion);
+                    tail->_size += portion;
+                    dest._size += portion;
+                    begin += portion;
+                }
+            }
+            auto& heap_manager = topology.template slot<vtm::HeapManagerSlot>();
+            const auto limit = chunk_limit(segments);
+            while (begin != end)
+            {
+                const auto portion = static_cast<vtm::segment_pos_t>(std::min<size_t>(limit, end - begin));
+                const auto capacity = std::min(limit, std::bit_ceil(std::max({
+                    portion, min_chunk_c, static_cast<vtm::segment_pos_t>(std::min<std::uint64_t>(dest._size, limit))
+                    })));
+                auto chunk = heap_manager.allocate(
+                    static_cast<vtm::segment_pos_t>(sizeof(BlobChunkHeader)) + capacity);
+                *vtm::accessor<BlobChunkHeader>(segments, chunk, vtm::WritableBlockHint::new_c) =
+                    BlobChunkHeader{ vtm::FarAddress{}, capacity, portion };
+                segments.writable_block(data_of(chunk), portion, vtm::WritableBlockHint::new_c)
+                    .byte_copy(begin, portion);
+                if (dest._tail.is_nil())
+                    dest._head = chunk;
+                else
+                    vtm::accessor<BlobChunkHeader>(segments, dest._tail)->_next = chunk;
+                dest._tail = chunk;
+                dest._size += portion;
+                begin += portion;
+            }
+        }
+
+        /**
+        *   Invoke `f(const ReadonlyMemoryChunk&)` for data of each chunk in order. Data is not copied,
+        *   chunk references persisted memory directly.
+        */
+        template <class F>
+        static void for_each_chunk(vtm::SegmentManager& segments, const storage_type_t& blob, F&& f)
+        {
+            for (auto chunk = blob._head; !chunk.is_nil(); )
+            {
+                auto [data, next] = read_chunk(segments, chunk);
+                f(data);
+                chunk = next;
+            }
+        }
+
+        /** \return data of the chunk at `chunk` address and address of the next chunk */
+        static std::pair<vtm::ReadonlyMemoryChunk, vtm::FarAddress> read_chunk(
+            vtm::SegmentManager& segments, vtm::FarAddress chunk)
+        {
+            auto header = vtm::view<BlobChunkHeader>(segments, chunk);
+            return { segments.readonly_block(data_of(chunk), header->_size), header->_next };
+        }
+
+    private:
+        static vtm::FarAddress data_of(vtm::FarAddress chunk) noexcept
+        {
+            return chunk + static_cast<vtm::segment_pos_t>(sizeof(BlobChunkHeader));
+        }
+
+        static vtm::segment_pos_t chunk_limit(const vtm::SegmentManager& segments) noexcept
+        {
+            return std::min(chunk_byte_limit, segments.segment_size() / 4);
+        }
+    };
+
+    /**
+    *   Payload manager for big string values (documents, images, ...). Value is kept as the chain
+    *   of chunks (\sa BlobConverter), so it may exceed the segment size. Besides regular access by
+    *   `std::string` the trie provides zero-copy reading by chunks (Trie::value_chunks) and appending
+    *   write (Trie::append_value).
+    *
+    *   \tparam chunk_byte_limit - max number of data bytes in the single chunk.
+    */
+    template <vtm::segment_pos_t chunk_byte_limit = 0x10000>
+    struct BlobValueManager
+    {
+        using source_payload_t = std::string;
+        using payload_t = BlobAddress;
+        using data_storage_t = BlobAddress;
+        using storage_converter_t = BlobConverter<chunk_byte_limit>;
+
+        template <class TSegmentTopology>
+        static void allocate(TSegmentTopology&, data_storage_t& storage)
+        {
+            ::new (&storage) data_storage_t{};
+        }
+
+        template <class TSegmentTopology>
+        static void destroy(TSegmentTopology& topology, data_storage_t& storage)
+        {
+            storage_converter_t::destroy(topology, storage);
+        }
+
+        template <class TSegmentTopology, class FRawDataCallback>
+        static void raw(TSegmentTopology&, data_storage_t& storage, FRawDataCallback payload_callback)
+        {
+            payload_callback(storage);
+        }
+
+        template <class TSegmentTopology, class FDataCallback>
+        static auto rawc(TSegmentTopology&, const data_storage_t& storage, FDataCallback payload_callback)
+        {
+            return payload_callback(storage);
+        }
+    };
+
+    /** Payload manager that keeps values as chain of chunks (\sa BlobValueManager) */
+    template <class T>
+    concept BlobPayloadManager = std::same_as<typename T::payload_t, BlobAddress>
+        && requires(vtm::SegmentManager & segments, vtm::FarAddress chunk)
+    {
+        T::storage_converter_t::read_chunk(segments, chunk);
+    };
+
+    /**
+    *   Sequence of blob chunks, each chunk is read in its own short transaction only when sequence
+    *   reaches it. Sequence keeps `owner` alive to guarantee the segment manager is valid.
+    */
+    template <class TConverter>
+    struct BlobChunkSequence : OP::flur::Sequence<const vtm::ReadonlyMemoryChunk&>
+    {
+        using base_t = OP::flur::Sequence<const vtm::ReadonlyMemoryChunk&>;
+        using element_t = typename base_t::element_t;
+
+        BlobChunkSequence(std::shared_ptr<const void> owner, vtm::SegmentManager* segments, BlobAddress blob) noexcept
+            : _owner(std::move(owner))
+            , _segments(segments)
+            , _blob(blob)
+        {
+        }
+
+        void start() override
+        {
+            _next = _blob._head;
+            next();
+        }
+
+        bool in_range() const override
+        {
+            return _has;
+        }
+
+        element_t current() const override
+        {
+            return _current;
+        }
+
+        void next() override
+        {
+            _has = !_next.is_nil();
+            if (!_has)
+            {
+                _current = vtm::ReadonlyMemoryChunk{};
+                return;
+            }
+            OP::vtm::TransactionGuard op_g(_segments->begin_transaction(), true);
+            auto [data, following] = TConverter::read_chunk(*_segments, _next);
+            _current = std::move(data);
+            _next = following;
+        }
+
+    private:
+        std::shared_ptr<const void> _owner;
+        vtm::SegmentManager* _segments;
+        BlobAddress _blob;
+        vtm::FarAddress _next;
+        vtm::ReadonlyMemoryChunk _current;
+        bool _has = false;
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_BLOBVALUEMANAGER__H_
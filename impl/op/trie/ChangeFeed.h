@@ -0,0 +1,412 @@
+#pragma once
+
+#ifndef _OP_TRIE_CHANGEFEED__H_
+#define _OP_TRIE_CHANGEFEED__H_
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <stdexcept>
+
+#include <op/flur/flur.h>
+#include <op/vtm/AppendOnlyLog.h>
+
+namespace OP::trie
+{
+    /** Kind of the Trie mutation captured by change feed (\sa Trie::change_feed) */
+    enum class ChangeKind : std::uint8_t
+    {
+        /** Reserved to mark record that is not completely written yet */
+        none = 0,
+        /** New key has been inserted */
+        insert,
+        /** Value of existing key has been changed */
+        update,
+        /** Single key has been erased */
+        erase,
+        /** All keys below the prefix have been erased, record tells if the prefix itself is erased as well */
+        prefixed_erase_all,
+        /** All keys of half-open interval [_key, _key_to) have been erased */
+        erase_range,
+        /** Bytes have been appended to the blob value at `_offset` (\sa Trie::append_value) */
+        append
+    };
+
+    /**
+    *   Rules to convert value of the Trie to plain bytes of the change record and back. Default implementation
+    *   supports trivially copyable types, specialize this template to support other payload types.
+    *   `encoded_size` must return exactly the number of bytes `encode` appends.
+    */
+    template <class T>
+    struct ChangeCodec
+    {
+        constexpr static bool supported_c = std::is_trivially_copyable_v<T>;
+
+        static std::size_t encoded_size(const T&) noexcept
+        {
+            return sizeof(T);
+        }
+
+        static void encode(const T& value, std::string& dest)
+        {
+            dest.append(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+
+        static T decode(const std::uint8_t* data, std::size_t size)
+        {
+            if (size != sizeof(T))
+                throw std::runtime_error("corrupted change record");
+            T result;
+            std::memcpy(&result, data, sizeof(T));
+            return result;
+        }
+    };
+
+    template <class Char, class Traits, class Alloc>
+    struct ChangeCodec<std::basic_string<Char, Traits, Alloc>>
+    {
+        using string_t = std::basic_string<Char, Traits, Alloc>;
+        constexpr static bool supported_c = std::is_trivially_copyable_v<Char>;
+
+        static std::size_t encoded_size(const string_t& value) noexcept
+        {
+            return value.size() * sizeof(Char);
+        }
+
+        static void encode(const string_t& value, std::string& dest)
+        {
+            dest.append(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(Char));
+        }
+
+        static string_t decode(const std::uint8_t* data, std::size_t size)
+        {
+            if (size % sizeof(Char))
+                throw std::runtime_error("corrupted change record");
+            string_t result(size / sizeof(Char), Char{});
+            std::memcpy(result.data(), data, size);
+            return result;
+        }
+    };
+
+    /**
+    *   Single mutation of the Trie, as it is written to/read from the change feed.
+    *
+    * \tparam Key - string-like type of key (the same as Trie::key_t);
+    * \tparam Value - type of value (the same as Trie::value_type).
+    */
+    template <class Key, class Value>
+    struct ChangeRecord
+    {
+        ChangeKind _kind = ChangeKind::none;
+        /** Version of the origin trie right after the operation that produced this record */
+        std::uint64_t _version = 0;
+        /** Key for insert/update/erase, prefix for prefixed_erase_all, lower boundary for erase_range */
+        Key _key;
+        /** Upper (exclusive) boundary for erase_range, empty otherwise */
+        Key _key_to;
+        /** New value for insert/update, appended bytes for append */
+        std::optional<Value> _value;
+        /** For append size of the value before the append */
+        std::uint64_t _offset = 0;
+        /** For prefixed_erase_all tells if the prefix itself has been erased */
+        bool _erase_prefix = false;
+    };
+
+    /**
+    *   Layout of the record inside block of AppendOnlyLog. Header is followed by atoms of `_key`,
+    *   atoms of `_key_to` and encoded bytes of value.
+    */
+    struct ChangeRecordHeader
+    {
+        std::uint64_t _version;
+        std::uint64_t _offset;
+        std::uint32_t _key_size;
+        std::uint32_t _key_to_size;
+        std::uint32_t _value_size;
+        std::uint8_t _erase_prefix;
+        /** Written last, so ChangeKind::none means that writer hasn't finished the record yet */
+        std::atomic<std::uint8_t> _kind;
+
+        const std::uint8_t* data() const noexcept
+        {
+            return reinterpret_cast<const std::uint8_t*>(this + 1);
+        }
+    };
+
+    /**
+    *   Writer side of the change feed. Appends compact records to the AppendOnlyLog in the order they are
+    *   written. Since AppendOnlyLog is thread safe, the same feed may be shared between several tries or threads.
+    */
+    class ChangeFeed
+    {
+    public:
+        explicit ChangeFeed(std::shared_ptr<vtm::AppendOnlyLog> log) noexcept
+            : _log(std::move(log))
+        {
+        }
+
+        const std::shared_ptr<vtm::AppendOnlyLog>& log() const noexcept
+        {
+            return _log;
+        }
+
+        /** Number of bytes the record occupies in the log */
+        template <class Key, class Value>
+        static std::size_t byte_size(const ChangeRecord<Key, Value>& record) noexcept
+        {
+            using atom_t = typename Key::value_type;
+            return sizeof(ChangeRecordHeader)
+                + (record._key.size() + record._key_to.size()) * sizeof(atom_t)
+                + (record._value ? ChangeCodec<Value>::encoded_size(*record._value) : 0);
+        }
+
+        /** Check if the record can be written, log cannot place a record that is bigger than its segment */
+        template <class Key, class Value>
+        bool fits(const ChangeRecord<Key, Value>& record) const noexcept
+        {
+            return byte_size(record) <= _log->max_allocation_size();
+        }
+
+        /**
+        *   Append record to the log. Record becomes visible for readers only after it is completely written.
+        * 	hrows std::length_error if record doesn't #fits the log.
+        */
+        template <class Key, class Value>
+        void write(const ChangeRecord<Key, Value>& record)
+        {
+            using atom_t = typename Key::value_type;
+            if (!fits(record))
+                throw std::length_error("change record exceeds segment of the log");
+            std::string value;
+            if (record._value)
+                ChangeCodec<Value>::encode(*record._value, value);
+            const auto key_bytes = record._key.size() * sizeof(atom_t);
+            const auto key_to_bytes = record._key_to.size() * sizeof(atom_t);
+
+            auto [address, buffer] = _log->allocate(static_cast<vtm::segment_pos_t>(
+                sizeof(ChangeRecordHeader) + key_bytes + key_to_bytes + value.size()));
+            auto* header = ::new (buffer) ChangeRecordHeader{
+                record._version,
+                record._offset,
+                static_cast<std::uint32_t>(record._key.size()),
+                static_cast<std::uint32_t>(record._key_to.size()),
+                static_cast<std::uint32_t>(value.size()),
+                static_cast<std::uint8_t>(record._erase_prefix),
+                static_cast<std::uint8_t>(ChangeKind::none)
+            };
+            auto* dest = buffer + sizeof(ChangeRecordHeader);
+            std::memcpy(dest, record._key.data(), key_bytes);
+            std::memcpy(dest + key_bytes, record._key_to.data(), key_to_bytes);
+            std::memcpy(dest + key_bytes + key_to_bytes, value.data(), value.size());
+            header->_kind.store(static_cast<std::uint8_t>(record._kind), std::memory_order_release);
+        }
+
+    private:
+        std::shared_ptr<vtm::AppendOnlyLog> _log;
+    };
+
+    /**
+    *   Reader side of the change feed. Keeps position in the log, so each next call continues
+    *   right after the last consumed record. That allows to tail the log while origin trie keeps writing.
+    *
+    * \tparam Key - string-like type of key (the same as Trie::key_t);
+    * \tparam Value - type of value (the same as Trie::value_type).
+    */
+    template <class Key, class Value>
+    class ChangeFeedReader
+    {
+    public:
+        using record_t = ChangeRecord<Key, Value>;
+
+        /**
+        * \param log - log written by ChangeFeed;
+        * \param position - where to start reading, nil address means the beginning of the log. To resume
+        *   replication after restart persist value of #position() and pass it there.
+        */
+        explicit ChangeFeedReader(std::shared_ptr<vtm::AppendOnlyLog> log, vtm::FarAddress position = {}) noexcept
+            : _log(std::move(log))
+            , _position(position)
+        {
+        }
+
+        /** Position of the first record that is not consumed yet */
+        vtm::FarAddress position() const noexcept
+        {
+            return _position;
+        }
+
+        /** Version of the origin trie carried by the last consumed record, 0 if nothing consumed yet */
+        std::uint64_t last_version() const noexcept
+        {
+            return _last_version;
+        }
+
+        /**
+        *   Consume next completely written record.
+        * \param dest - receives the record;
+        * \return false if there are no more records available at the moment.
+        */
+        bool read(record_t& dest)
+        {
+            bool consumed = false;
+            auto resume = _log->for_each_from(_position, [&](const ChangeRecordHeader* header) -> bool {
+                if (consumed) //peek only to resolve address of the next record
+                    return false;
+                const auto kind = static_cast<ChangeKind>(header->_kind.load(std::memory_order_acquire));
+                if (kind == ChangeKind::none) //writer is still busy with this record
+                    return false;
+                decode(kind, *header, dest);
+                return consumed = true;
+            });
+            if (consumed)
+            {
+                _position = resume;
+                _last_version = dest._version;
+            }
+            return consumed;
+        }
+
+        /**
+        *   LazyRange of records available at the moment. Range consumes records from this reader, so
+        *   evaluating the same range again continues from the place where previous evaluation stopped.
+        *   Reader must outlive the range.
+        */
+        auto changes()
+        {
+            return OP::flur::make_lazy_range(
+                OP::flur::SimpleFactory<Sequence, ChangeFeedReader*>(this));
+        }
+
+        /**
+        *   Apply all available records to the `replica` trie (\sa apply_change).
+        * \return number of applied records.
+        */
+        template <class TTrie>
+        size_t apply_to(TTrie& replica)
+        {
+            size_t result = 0;
+            for (record_t record; read(record); ++result)
+                apply_change(replica, record);
+            return result;
+        }
+
+    private:
+        struct Sequence : OP::flur::Sequence<const record_t&>
+        {
+            using base_t = OP::flur::Sequence<const record_t&>;
+            using element_t = typename base_t::element_t;
+
+            explicit Sequence(ChangeFeedReader* reader) noexcept
+                : _reader(reader)
+            {
+            }
+
+            void start() override
+            {
+                _has = _reader->read(_current);
+            }
+
+            bool in_range() const override
+            {
+                return _has;
+            }
+
+            element_t current() const override
+            {
+                return _current;
+            }
+
+            void next() override
+            {
+                _has = _reader->read(_current);
+            }
+
+        private:
+            ChangeFeedReader* _reader;
+            record_t _current;
+            bool _has = false;
+        };
+
+        static void decode(ChangeKind kind, const ChangeRecordHeader& header, record_t& dest)
+        {
+            using atom_t = typename Key::value_type;
+            const auto* key = reinterpret_cast<const atom_t*>(header.data());
+            const auto* key_to = key + header._key_size;
+            dest._kind = kind;
+            dest._version = header._version;
+            dest._key.clear();
+            dest._key.append(key, key + header._key_size);
+            dest._key_to.clear();
+            dest._key_to.append(key_to, key_to + header._key_to_size);
+            dest._erase_prefix = header._erase_prefix != 0;
+            dest._offset = header._offset;
+            if (kind == ChangeKind::insert || kind == ChangeKind::update || kind == ChangeKind::append)
+                dest._value.emplace(ChangeCodec<Value>::decode(
+                    reinterpret_cast<const std::uint8_t*>(key_to + header._key_to_size), header._value_size));
+            else
+                dest._value.reset();
+        }
+
+        std::shared_ptr<vtm::AppendOnlyLog> _log;
+        vtm::FarAddress _position;
+        std::uint64_t _last_version = 0;
+    };
+
+    /**
+    *   Apply single change record to the `replica` trie. Every kind of record is idempotent, so replaying
+    *   records that have been applied already leaves replica in the same state (append is applied only
+    *   when size of replica value matches the offset of the record).
+    * \throws std::invalid_argument if record has unknown kind or append record is applied to the trie
+    *   without blob values.
+    */
+    template <class TTrie, class Key, class Value>
+    void apply_change(TTrie& replica, const ChangeRecord<Key, Value>& record)
+    {
+        switch (record._kind)
+        {
+        case ChangeKind::insert:
+        case ChangeKind::update:
+        {
+            auto root = replica.end();
+            replica.prefixed_upsert(root, std::begin(record._key), std::end(record._key), *record._value);
+            break;
+        }
+        case ChangeKind::erase:
+        {
+            auto found = replica.find(record._key);
+            if (!found.is_end())
+                replica.erase(found);
+            break;
+        }
+        case ChangeKind::prefixed_erase_all:
+        {
+            auto found = replica.find(record._key);
+            if (!found.is_end())
+                replica.prefixed_erase_all(found, record._erase_prefix);
+            break;
+        }
+        case ChangeKind::erase_range:
+            replica.erase_range(record._key, record._key_to);
+            break;
+        case ChangeKind::append:
+            if constexpr (requires(typename TTrie::iterator& pos) { replica.append_value(pos, *record._value); })
+            {
+                auto found = replica.find(record._key);
+                if (!found.is_end() && replica.value_size(found) == record._offset)
+                    replica.append_value(found, *record._value);
+                break;
+            }
+            else
+                throw std::invalid_argument("append record needs trie with blob values");
+        default:
+            throw std::invalid_argument("unknown kind of change record");
+        }
+    }
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_CHANGEFEED__H_
@@ -0,0 +1,511 @@
+#pragma once
+
+#ifndef _OP_TRIE_COMPRESSEDVALUEMANAGER__H_
+#define _OP_TRIE_COMPRESSEDVALUEMANAGER__H_
+
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <concepts>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+
+#include <op/vtm/SegmentManager.h>
+#include <op/vtm/SegmentTopology.h>
+#include <op/vtm/MemoryChunks.h>
+#include <op/vtm/slots/HeapManager.h>
+
+namespace OP::trie
+{
+    /**
+    *   Self-contained LZ77 codec (LZ4-like byte format) that can reference bytes of the preset
+    *   dictionary as if dictionary was placed right before the encoded value. That makes
+    *   compression of small values efficient: repeating parts (field names, common tokens) are
+    *   taken from the dictionary even if they occur only once in the value.
+    *
+    *   Encoded stream is a sequence of: token byte (high nibble - number of literals, low nibble - match
+    *   length minus #min_match_c, value 15 means that length continues in the next bytes), literals,
+    *   2-byte little-endian distance back to the match start and optional length continuation. The last
+    *   sequence has only literals, decoder detects it by the known size of raw value.
+    */
+    struct DictionaryLz
+    {
+        constexpr static size_t min_match_c = 4;
+        constexpr static size_t max_distance_c = 0xFFFF;
+        constexpr static unsigned dictionary_hash_bits_c = 14;
+        constexpr static unsigned value_hash_bits_c = 12;
+
+        /** Dictionary prepared for compression: bytes and hash of each 4-byte sequence of it */
+        struct Index
+        {
+            std::string _bytes;
+            /** Position of sequence + 1, 0 means empty slot */
+            std::vector<std::uint32_t> _table;
+
+            explicit Index(std::string bytes = {})
+                : _bytes(std::move(bytes))
+                , _table(size_t{ 1 } << dictionary_hash_bits_c, 0)
+            {
+                for (size_t i = 0; i + min_match_c <= _bytes.size(); ++i)
+                    _table[hash(_bytes.data() + i, dictionary_hash_bits_c)] = static_cast<std::uint32_t>(i + 1);
+            }
+        };
+
+        /** Append encoded `[src, src + size)` to `out` */
+        static void compress(const Index& dictionary, const char* src, size_t size, std::string& out)
+        {
+            const char* dict = dictionary._bytes.data();
+            const size_t dict_size = dictionary._bytes.size();
+            std::vector<std::uint32_t> local(size_t{ 1 } << value_hash_bits_c, 0);
+            size_t anchor = 0, i = 0;
+            while (i + min_match_c <= size)
+            {
+                size_t best_len = 0, best_distance = 0;
+                if (auto candidate = local[hash(src + i, value_hash_bits_c)]; candidate)
+                {
+                    const size_t j = candidate - 1;
+                    if (i - j <= max_distance_c)
+                    {
+                        best_len = common_length(src + j, src + size, src + i, src + size);
+                        best_distance = i - j;
+                    }
+                }
+                if (auto candidate = dictionary._table[hash(src + i, dictionary_hash_bits_c)]; candidate)
+                {
+                    const size_t k = candidate - 1;
+                    const size_t distance = dict_size - k + i;
+                    if (distance <= max_distance_c)
+                    {
+                        const auto len = common_length(dict + k, dict + dict_size, src + i, src + size);
+                        if (len > best_len)
+                        {
+                            best_len = len;
+                            best_distance = distance;
+                        }
+                    }
+                }
+                local[hash(src + i, value_hash_bits_c)] = static_cast<std::uint32_t>(i + 1);
+                if (best_len < min_match_c)
+                {
+                    ++i;
+                    continue;
+                }
+                emit(out, src + anchor, i - anchor, best_len - min_match_c);
+                out.push_back(static_cast<char>(best_distance & 0xFF));
+                out.push_back(static_cast<char>(best_distance >> 8));
+                emit_length(out, best_len - min_match_c);
+                i += best_len;
+                anchor = i;
+            }
+            emit(out, src + anchor, size - anchor, 0); //trailing literals
+        }
+
+        /**
+        *   Decode `[src, src + size)` that has been produced by #compress with the same dictionary.
+        * \throws std::runtime_error if encoded data is corrupted.
+        */
+        static std::string decompress(std::string_view dictionary, const std::uint8_t* src, size_t size, size_t raw_size)
+        {
+            std::string result;
+            result.reserve(raw_size);
+            const auto* end = src + size;
+            for (;;)
+            {
+                if (src == end) //valid stream always ends with literals-only sequence
+                    throw std::runtime_error("corrupted compressed value");
+                const auto token = *src++;
+                const size_t literals = read_length(src, end, token >> 4);
+                if (static_cast<size_t>(end - src) < literals || raw_size - result.size() < literals)
+                    throw std::runtime_error("corrupted compressed value");
+                result.append(reinterpret_cast<const char*>(src), literals);
+                src += literals;
+                if (result.size() == raw_size)
+                    break; //the last sequence
+                if (end - src < 2)
+                    throw std::runtime_error("corrupted compressed value");
+                const size_t distance = src[0] | (size_t{ src[1] } << 8);
+                src += 2;
+                const size_t match = read_length(src, end, token & 0xF) + min_match_c;
+                const size_t window = dictionary.size() + result.size();
+                if (distance == 0 || distance > window || raw_size - result.size() < match)
+                    throw std::runtime_error("corrupted compressed value");
+                for (size_t from = window - distance, n = 0; n < match; ++n, ++from)
+                { //byte by byte since source may overlap destination
+                    result.push_back(from < dictionary.size()
+                        ? dictionary[from] : result[from - dictionary.size()]);
+                }
+            }
+            return result;
+        }
+
+    private:
+        static std::uint32_t hash(const char* p, unsigned bits) noexcept
+        {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+            return (v * 2654435761u) >> (32 - bits);
+        }
+
+        static size_t common_length(const char* a, const char* a_end, const char* b, const char* b_end) noexcept
+        {
+            return static_cast<size_t>(std::mismatch(a, a_end, b, b_end).first - a);
+        }
+
+        static void emit(std::string& out, const char* literals, size_t count, size_t match_code)
+        {
+            out.push_back(static_cast<char>(
+                (std::min<size_t>(count, 15) << 4) | std::min<size_t>(match_code, 15)));
+            emit_length(out, count);
+            out.append(literals, count);
+        }
+
+        /** Write continuation of the length if it doesn't fit to nibble */
+        static void emit_length(std::string& out, size_t length)
+        {
+            if (length < 15)
+                return;
+            for (length -= 15; length >= 255; length -= 255)
+                out.push_back(static_cast<char>(255));
+            out.push_back(static_cast<char>(length));
+        }
+
+        static size_t read_length(const std::uint8_t*& src, const std::uint8_t* end, size_t nibble)
+        {
+            if (nibble < 15)
+                return nibble;
+            for (std::uint8_t next = 255; next == 255; nibble += next)
+            {
+                if (src == end)
+                    throw std::runtime_error("corrupted compressed value");
+                next = *src++;
+            }
+            return nibble;
+        }
+    };
+
+    /**
+    *   Slot that keeps dictionary shared by all values of CompressedValueManager. Slot resides in 0 segment,
+    *   dictionary is trained once (\sa Trie::train_compression) and never changes after that, so values
+    *   encoded with it stay decodable. Persisted dictionary is cached in memory together with its hash table.
+    */
+    struct CompressionDictionary : public vtm::Slot
+    {
+        using FarAddress = vtm::FarAddress;
+        using segment_idx_t = vtm::segment_idx_t;
+        using segment_pos_t = vtm::segment_pos_t;
+
+        /** Max byte size of the dictionary */
+        constexpr static segment_pos_t capacity_c = 0x4000;
+
+        /** Plain data structure to store state of dictionary, followed by #capacity_c bytes */
+        struct DictionaryHeader
+        {
+            std::uint32_t _size = 0;
+            /** FNV-1a of dictionary bytes, 0 means dictionary is not trained yet */
+            std::uint64_t _checksum = 0;
+        };
+
+        using index_ptr_t = std::shared_ptr<const DictionaryLz::Index>;
+
+        explicit CompressionDictionary(vtm::SegmentManager& manager) noexcept
+            : Slot(manager)
+        {
+        }
+
+        /** \return checksum of the current dictionary or 0 if it is not trained yet */
+        std::uint64_t checksum() const
+        {
+            return vtm::view<DictionaryHeader>(segment_manager(), _segment_address)->_checksum;
+        }
+
+        /** \return current dictionary, refreshes memory cache if persisted state has been changed */
+        index_ptr_t current() const
+        {
+            const auto header = *vtm::view<DictionaryHeader>(segment_manager(), _segment_address);
+            std::lock_guard<std::mutex> guard(_cache_lock);
+            if (!_cache || _cache_checksum != header._checksum)
+            {
+                std::string bytes;
+                if (header._size)
+                {
+                    auto ro = segment_manager().readonly_block(data_address(), header._size);
+                    bytes.assign(ro.at<char>(0), header._size);
+                }
+                _cache = std::make_shared<const DictionaryLz::Index>(std::move(bytes));
+                _cache_checksum = header._checksum;
+            }
+            return _cache;
+        }
+
+        /**
+        *   Build dictionary from the most frequent fragments of `samples`. Must be called in transaction scope.
+        * \tparam Samples - range of string-like values.
+        * \throws std::logic_error if dictionary has been already trained.
+        */
+        template <class Samples>
+        void train(const Samples& samples)
+        {
+            if (checksum())
+                throw std::logic_error("compression dictionary is already trained");
+            auto bytes = build(samples);
+            if (bytes.empty())
+                return;
+            segment_manager().writable_block(data_address(), static_cast<segment_pos_t>(bytes.size()))
+                .byte_copy(bytes.data(), static_cast<segment_pos_t>(bytes.size()));
+            *vtm::accessor<DictionaryHeader>(segment_manager(), _segment_address) = DictionaryHeader{
+                static_cast<std::uint32_t>(bytes.size()), fnv1a(bytes)
+            };
+        }
+
+        /**
+        *   Build content of dictionary from the most frequent fragments of `samples` without persisting it.
+        * \tparam Samples - range of string-like values, they must outlive the call.
+        */
+        template <class Samples>
+        static std::string build(const Samples& samples)
+        {
+            struct Candidate
+            {
+                size_t _count = 0;
+                std::string_view _fragment;
+            };
+            std::unordered_map<std::uint64_t, Candidate> frequency;
+            for (const auto& sample : samples)
+            {
+                std::string_view value(std::data(sample), std::size(sample));
+                for (size_t pos = 0; pos + gram_c <= value.size(); ++pos)
+                {
+                    auto& candidate = frequency[fnv1a(value.substr(pos, gram_c))];
+                    if (!candidate._count++)
+                        candidate._fragment = value.substr(pos, fragment_c);
+                }
+            }
+            std::vector<const Candidate*> ordered;
+            for (const auto& [hash, candidate] : frequency)
+                if (candidate._count > 1)
+                    ordered.push_back(&candidate);
+            std::sort(ordered.begin(), ordered.end(), [](const auto* left, const auto* right) {
+                return left->_count > right->_count
+                    || (left->_count == right->_count && left->_fragment < right->_fragment);
+                });
+            std::string result;
+            std::unordered_set<std::uint64_t> covered;
+            for (const auto* candidate : ordered)
+            {
+                const auto fragment = candidate->_fragment;
+                if (covered.count(fnv1a(fragment.substr(0, gram_c))))
+                    continue;
+                if (result.size() + fragment.size() > capacity_c)
+                    break;
+                for (size_t pos = 0; pos + gram_c <= fragment.size(); ++pos)
+                    covered.insert(fnv1a(fragment.substr(pos, gram_c)));
+                result.append(fragment);
+            }
+            return result;
+        }
+
+    protected:
+        //
+        //  Overrides
+        //
+        /**Slot resides in zero-segment only*/
+        bool has_residence(segment_idx_t segment_idx) const override
+        {
+            return segment_idx == 0;
+        }
+
+        segment_pos_t byte_size(FarAddress segment_address) const override
+        {
+            assert(segment_address.segment() == 0);
+            return static_cast<segment_pos_t>(sizeof(DictionaryHeader)) + capacity_c;
+        }
+
+        void on_new_segment(FarAddress segment_address) override
+        {
+            assert(segment_address.segment() == 0);
+            _segment_address = segment_address;
+            *vtm::accessor<DictionaryHeader>(segment_manager(), segment_address, OP::vtm::WritableBlockHint::new_c)
+                = DictionaryHeader{};
+        }
+
+        void open(FarAddress segment_address) override
+        {
+            assert(segment_address.segment() == 0);
+            _segment_address = segment_address;
+        }
+
+        void release_segment(segment_idx_t segment_index) override
+        {
+            /* do nothing */
+        }
+
+    private:
+        /** Length of fragment used to count frequency */
+        constexpr static size_t gram_c = 8;
+        /** Length of fragment copied to the dictionary around frequent gram */
+        constexpr static size_t fragment_c = 32;
+
+        FarAddress data_address() const noexcept
+        {
+            return _segment_address + static_cast<segment_pos_t>(sizeof(DictionaryHeader));
+        }
+
+        static std::uint64_t fnv1a(std::string_view bytes) noexcept
+        {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            for (auto c : bytes)
+            {
+                h ^= static_cast<std::uint8_t>(c);
+                h *= 0x100000001b3ull;
+            }
+            return h ? h : 1;
+        }
+
+        FarAddress _segment_address;
+        mutable std::mutex _cache_lock;
+        mutable index_ptr_t _cache;
+        mutable std::uint64_t _cache_checksum = 0;
+    };
+
+    /** Persisted reference to the compressed value */
+    struct CompressedAddress
+    {
+        vtm::FarAddress _data;
+        std::uint32_t _compressed_size = 0;
+        std::uint32_t _raw_size = 0;
+        /** Checksum of the dictionary used to encode value, 0 if value is encoded without dictionary */
+        std::uint64_t _dictionary = 0;
+    };
+
+    /**
+    *   Storage converter (\sa store_converter::Storage) that keeps std::string compressed by DictionaryLz
+    *   in the block allocated by HeapManagerSlot. Topology must contain CompressionDictionary slot.
+    */
+    struct CompressedConverter
+    {
+        using type_t = std::string;
+        using storage_type_t = CompressedAddress;
+
+        template <class TTopology>
+        static void serialize(TTopology& topology, const type_t& source, storage_type_t& dest)
+        {
+            dest = storage_type_t{};
+            if (source.empty())
+                return;
+            auto& dictionary = topology.template slot<CompressionDictionary>();
+            auto index = dictionary.current();
+            std::string encoded;
+            DictionaryLz::compress(*index, source.data(), source.size(), encoded);
+            auto& segments = vtm::resolve_segment_manager(topology);
+            if (encoded.size() >= segments.segment_size())
+                throw std::out_of_range("compressed value must be less than segment size");
+            const auto size = static_cast<vtm::segment_pos_t>(encoded.size());
+            dest._data = topology.template slot<vtm::HeapManagerSlot>().allocate(size);
+            segments.writable_block(dest._data, size, vtm::WritableBlockHint::new_c)
+                .byte_copy(encoded.data(), size);
+            dest._compressed_size = size;
+            dest._raw_size = static_cast<std::uint32_t>(source.size());
+            dest._dictionary = index->_bytes.empty() ? 0 : dictionary.checksum();
+        }
+
+        template <class TTopology>
+        static void reassign(TTopology& topology, const type_t& source, storage_type_t& dest)
+        {
+            destroy(topology, dest);
+            serialize(topology, source, dest);
+        }
+
+        /**
+        *   Decompress value, it happens only when value is accessed.
+        * \throws std::runtime_error if value was encoded with dictionary other than current.
+        */
+        template <class TTopology>
+        static type_t deserialize(TTopology& topology, const storage_type_t& source)
+        {
+            if (source._data.is_nil())
+                return type_t{};
+            auto& dictionary = topology.template slot<CompressionDictionary>();
+            std::string_view dictionary_bytes;
+            CompressionDictionary::index_ptr_t index;
+            if (source._dictionary)
+            {
+                index = dictionary.current();
+                if (dictionary.checksum() != source._dictionary)
+                    throw std::runtime_error("value is compressed with unknown dictionary");
+                dictionary_bytes = index->_bytes;
+            }
+            auto ro = vtm::resolve_segment_manager(topology).readonly_block(source._data, source._compressed_size);
+            return DictionaryLz::decompress(
+                dictionary_bytes, ro.template at<std::uint8_t>(0), source._compressed_size, source._raw_size);
+        }
+
+        template <class TTopology>
+        static void destroy(TTopology& topology, storage_type_t& dest)
+        {
+            if (!dest._data.is_nil())
+                topology.template slot<vtm::HeapManagerSlot>().deallocate(dest._data);
+            dest = storage_type_t{};
+        }
+    };
+
+    /**
+    *   Payload manager for small redundant string values (JSON-like records). Each value is compressed
+    *   with the dictionary shared by whole trie (\sa CompressionDictionary) and decompressed only when it is
+    *   accessed. Values inserted before dictionary is trained are compressed without dictionary and stay valid.
+    *   Manager requires own slot in the trie topology (\sa topology_slots_t).
+    */
+    struct CompressedValueManager
+    {
+        using source_payload_t = std::string;
+        using payload_t = CompressedAddress;
+        using data_storage_t = CompressedAddress;
+        using storage_converter_t = CompressedConverter;
+        /** Additional slots that Trie places to the topology */
+        using topology_slots_t = std::tuple<CompressionDictionary>;
+
+        template <class TSegmentTopology>
+        static void allocate(TSegmentTopology&, data_storage_t& storage)
+        {
+            ::new (&storage) data_storage_t{};
+        }
+
+        template <class TSegmentTopology>
+        static void destroy(TSegmentTopology& topology, data_storage_t& storage)
+        {
+            storage_converter_t::destroy(topology, storage);
+        }
+
+        template <class TSegmentTopology, class FRawDataCallback>
+        static void raw(TSegmentTopology&, data_storage_t& storage, FRawDataCallback payload_callback)
+        {
+            payload_callback(storage);
+        }
+
+        template <class TSegmentTopology, class FDataCallback>
+        static auto rawc(TSegmentTopology&, const data_storage_t& storage, FDataCallback payload_callback)
+        {
+            return payload_callback(storage);
+        }
+
+        /** Train shared dictionary on the `samples`, must be called in transaction scope */
+        template <class TSegmentTopology, class Samples>
+        static void train(TSegmentTopology& topology, const Samples& samples)
+        {
+            topology.template slot<CompressionDictionary>().train(samples);
+        }
+    };
+
+    /** Payload manager that compresses values with trainable dictionary (\sa CompressedValueManager) */
+    template <class T>
+    concept CompressingPayloadManager = std::same_as<typename T::payload_t, CompressedAddress>;
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_COMPRESSEDVALUEMANAGER__H_
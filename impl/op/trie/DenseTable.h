@@ -0,0 +1,228 @@
+#ifndef _OP_TRIE_DENSETABLE__H_
+#define _OP_TRIE_DENSETABLE__H_
+
+#include <algorithm>
+
+#include <op/vtm/SegmentManager.h>
+#include <op/vtm/PersistedReference.h>
+#include <op/trie/KeyValueContainer.h>
+
+namespace OP::trie::containers
+{
+    namespace details
+    {
+        /** Flag of TrieNode capacity that marks dense (rank indexed) layout of KeyValueContainer.
+        * Flag allows distinguish dense layout from the PersistedHashTable of the same size
+        */
+        constexpr inline dim_t dense_layout_c = 0x8000;
+
+        /** Numbers of slots supported by dense layout, ordered ascending */
+        constexpr inline dim_t dense_slots_c[] = { 4, 16, 48 };
+
+        constexpr inline bool is_dense(dim_t capacity) noexcept
+        {
+            return (capacity & dense_layout_c) != 0;
+        }
+
+        /** \return number of entries that can be stored by container of specified `capacity` */
+        constexpr inline dim_t slots(dim_t capacity) noexcept
+        {
+            return static_cast<dim_t>(capacity & ~dense_layout_c);
+        }
+
+        /** \return capacity of dense layout with specified number of slots */
+        constexpr inline dim_t dense_capacity(dim_t slots) noexcept
+        {
+            assert(std::find(std::begin(dense_slots_c), std::end(dense_slots_c), slots)
+                != std::end(dense_slots_c));
+            return static_cast<dim_t>(slots | dense_layout_c);
+        }
+
+        /** Define how node grows on reaching size limit: dense 4 -> dense 16 -> dense 48 -> 256
+        * (AntiHashTable). Legacy hash-table layouts migrate to the smallest bigger step of the same ladder
+        */
+        constexpr inline dim_t node_grow_size(dim_t capacity) noexcept
+        {
+            const dim_t current = slots(capacity);
+            assert(current < 256); //must never grow from 256
+            for (auto step : dense_slots_c)
+                if (step > current)
+                    return dense_capacity(step);
+            return 256;
+        }
+
+        /** Evaluate smallest node capacity that can accommodate `entries` items at once */
+        constexpr inline dim_t fit_capacity(dim_t entries) noexcept
+        {
+            assert(entries <= 256);
+            for (auto step : dense_slots_c)
+                if (entries <= step)
+                    return dense_capacity(step);
+            return 256;
+        }
+    }//ns:details
+
+    /** Implement compact table to persist Payload by key for nodes with few entries.
+    * In compare to HashTable<Payload> class doesn't persist keys at all, instead entries are kept
+    * sorted in the order of keys, so position of the entry is a rank of the key in the parent's presence
+    * bitset (number of set bits below the key). Insert and erase shift tail of the table, this is cheap
+    * since table never exceeds 48 entries.
+    *   Since index is evaluated from presence, ParentInfo must modify presence bits only after
+    * #insert / #erase and additionally support:
+    *   \li `dim_t presence_rank(atom_t key) const` - number of entries with key less than specified;
+    *   \li `presence_union()` - bitset of all entries that supports `count_bits()`;
+    */
+    template <class Payload, class ParentInfo>
+    struct DenseTable : KeyValueContainer<Payload, ParentInfo>
+    {
+        using this_t = DenseTable<Payload, ParentInfo>;
+        using base_t = KeyValueContainer<Payload, ParentInfo>;
+        using FarAddress = vtm::FarAddress;
+
+        using persisted_table_t = vtm::PersistedArray<Payload>;
+        using const_persisted_table_t = vtm::ConstantPersistedArray<Payload>;
+        using payload_factory_t = typename base_t::FPayloadFactory;
+
+        /**
+        * \tparam some specialization of SegmentTopology with mandatory slot `HeapManagerSlot`
+        * \param capacity - dense capacity (\sa details::dense_capacity)
+        */
+        template <class TSegmentTopology>
+        DenseTable(TSegmentTopology& topology,
+                const ParentInfo& node_info,
+                dim_t capacity)
+            : _segment_manager(topology.segment_manager())
+            , _heap_manager(topology.template slot<vtm::HeapManagerSlot>())
+            , _node_info(node_info)
+            , _slots(details::slots(capacity))
+        {
+            assert(details::is_dense(capacity));
+        }
+
+        FarAddress create() override
+        {
+            auto byte_size = persisted_table_t::memory_requirement(_slots);
+
+            persisted_table_t result { _heap_manager.allocate(byte_size) };
+            auto* container = result.ref(_segment_manager, _slots);
+            for(dim_t i = 0; i < _slots; ++i)
+                container[i] = {};
+            return result.address;
+        }
+
+        /** Destroy on persisted layer entire table block previously allocated by this #create */
+        void destroy(FarAddress tbl) override
+        {
+            _heap_manager.deallocate(tbl);
+        }
+
+        std::pair<dim_t, bool> insert(
+            atom_t key, const payload_factory_t& payload_factory) override
+        {
+            assert(!_node_info.presence(key));
+            const dim_t count = size();
+            if (count == _slots)
+                return std::pair<dim_t, bool>(vtm::dim_nil_c, false); //no more capacity
+            const dim_t pos = _node_info.presence_rank(key);
+
+            persisted_table_t ref_data(_node_info.reindex_table());
+            auto* data = ref_data.ref(_segment_manager, _slots);
+            //free slot for new entry by shifting tail to the right
+            std::move_backward(data + pos, data + count, data + count + 1);
+            payload_factory.inplace_construct(data[pos]);
+            return std::pair<dim_t, bool>(pos, true);
+        }
+
+        atom_t hash(atom_t key) const override
+        {
+            return static_cast<atom_t>(_node_info.presence_rank(key));
+        }
+
+        atom_t reindex(atom_t key) const override
+        {
+            assert(_node_info.presence(key));
+            return static_cast<atom_t>(_node_info.presence_rank(key));
+        }
+
+        /** Try locate index in `ref_data` by key.
+        * @return index or dim_nil_c if no key contained in ref_data
+        */
+        virtual dim_t find(atom_t key) const override
+        {
+            if(_node_info.presence(key))
+                return _node_info.presence_rank(key);
+            return vtm::dim_nil_c;
+        }
+
+        Payload* get(atom_t key) override
+        {
+            if(!_node_info.presence(key))
+                return nullptr;
+            persisted_table_t ref_data(_node_info.reindex_table());
+            return &ref_data.ref_element( _segment_manager, _node_info.presence_rank(key) );
+        }
+
+        std::optional<Payload> cget(atom_t key) const override
+        {
+            if(_node_info.presence(key))
+            {
+                const_persisted_table_t ref_data(_node_info.reindex_table());
+                auto refview = ref_data.ref_element(
+                    _segment_manager, _node_info.presence_rank(key));
+                return std::optional<Payload>(*refview);
+            }
+            return std::optional<Payload>();
+        }
+
+        bool erase(atom_t key) override
+        {
+            assert(_node_info.presence(key));
+            const dim_t count = size();
+            const dim_t pos = _node_info.presence_rank(key);
+
+            persisted_table_t ref_data(_node_info.reindex_table());
+            auto* data = ref_data.ref(_segment_manager, _slots);
+            std::destroy_at(data + pos);
+            //close the gap by shifting tail to the left
+            std::move(data + pos + 1, data + count, data + pos);
+            data[count - 1] = {};
+            return true;
+        }
+
+         bool grow_from(base_t& from, FarAddress& result) override
+         {
+            if (size() > _slots)
+                return false; //continue growing
+            result = create();
+
+            persisted_table_t to_ref(result);
+            auto* to_data = to_ref.ref(_segment_manager, _slots);
+
+            dim_t pos = 0;
+            //iterate only over occupied slots, presence order gives exactly rank
+            for(auto i = _node_info.presence_first_set();
+                i != vtm::dim_nil_c;
+                i = _node_info.presence_next_set(static_cast<atom_t>(i)), ++pos)
+            {
+                auto *v = from.get(static_cast<atom_t>(i));
+                assert(v); //must exists since presence() == true
+                to_data[pos] = std::move(*v);
+            }
+            return true;
+         }
+
+    private:
+        /** number of occupied slots */
+        dim_t size() const
+        {
+            return _node_info.presence_union().count_bits();
+        }
+
+        vtm::SegmentManager& _segment_manager;
+        vtm::HeapManagerSlot& _heap_manager;
+        const ParentInfo& _node_info;
+        const dim_t _slots;
+    };
+}//ns: OP::trie::containers
+
+#endif //_OP_TRIE_DENSETABLE__H_
@@ -0,0 +1,129 @@
+#pragma once
+
+#ifndef _OP_TRIE_EXPIRINGVALUEMANAGER__H_
+#define _OP_TRIE_EXPIRINGVALUEMANAGER__H_
+
+#include <cstdint>
+#include <chrono>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+#include <op/trie/PlainValueManager.h>
+
+namespace OP::trie
+{
+    /** Point of time when entry expires, milliseconds since epoch of std::chrono::system_clock */
+    using expiry_t = std::uint64_t;
+
+    /** Special value of expiry_t to mark entry that never expires */
+    constexpr inline expiry_t never_expire_c = 0;
+
+    /** Conversion between std::chrono and expiry_t */
+    struct ExpiryClock
+    {
+        using clock_t = std::chrono::system_clock;
+
+        static expiry_t now() noexcept
+        {
+            return to_expiry(clock_t::now());
+        }
+
+        static expiry_t to_expiry(clock_t::time_point point) noexcept
+        {
+            return static_cast<expiry_t>(
+                std::chrono::duration_cast<std::chrono::milliseconds>(point.time_since_epoch()).count());
+        }
+
+        /** Expiry point that is `ttl` later than current time */
+        template <class Rep, class Period>
+        static expiry_t after(std::chrono::duration<Rep, Period> ttl) noexcept
+        {
+            return to_expiry(clock_t::now() + std::chrono::duration_cast<clock_t::duration>(ttl));
+        }
+
+        /** \return true if entry with expiration point `expire_at` is not visible anymore at `now` */
+        static constexpr bool is_expired(expiry_t expire_at, expiry_t now) noexcept
+        {
+            return expire_at != never_expire_c && expire_at <= now;
+        }
+    };
+
+    /** Storage of ExpiringValueManager, keeps expiration point right after the storage of base manager */
+    template <class TBaseStorage>
+    struct ExpiringDataStorage
+    {
+        TBaseStorage _value;
+        expiry_t _expire_at;
+    };
+
+    /**
+    *   Payload manager that decorates another payload manager (by default PlainValueManager) with
+    *   expiration point stored next to the value in the trie node. Any newly inserted value never expires
+    *   until Trie::expire is called, update of the value keeps expiration point unchanged.
+    *
+    *   \tparam TBaseManager - payload manager that keeps the value itself (\sa PlainValueManager)
+    */
+    template <class TBaseManager>
+    struct ExpiringValueManager
+    {
+        using base_manager_t = TBaseManager;
+        using source_payload_t = typename base_manager_t::source_payload_t;
+        using payload_t = typename base_manager_t::payload_t;
+        using storage_converter_t = typename base_manager_t::storage_converter_t;
+        using data_storage_t = ExpiringDataStorage<typename base_manager_t::data_storage_t>;
+
+        static_assert(std::is_standard_layout_v<data_storage_t>,
+            "base manager must provide standard-layout storage");
+
+        template <class TSegmentTopology>
+        static void allocate(TSegmentTopology& topology, data_storage_t& storage)
+        {
+            base_manager_t::allocate(topology, storage._value);
+            storage._expire_at = never_expire_c;
+        }
+
+        template <class TSegmentTopology>
+        static void destroy(TSegmentTopology& topology, data_storage_t& storage)
+        {
+            base_manager_t::destroy(topology, storage._value);
+        }
+
+        template <class TSegmentTopology, class FRawDataCallback>
+        static void raw(TSegmentTopology& topology, data_storage_t& storage, FRawDataCallback payload_callback)
+        {
+            base_manager_t::raw(topology, storage._value, std::move(payload_callback));
+        }
+
+        template <class TSegmentTopology, class FDataCallback>
+        static auto rawc(TSegmentTopology& topology, const data_storage_t& storage, FDataCallback payload_callback)
+        {
+            return base_manager_t::rawc(topology, storage._value, std::move(payload_callback));
+        }
+
+        static expiry_t expire_at(const data_storage_t& storage) noexcept
+        {
+            return storage._expire_at;
+        }
+
+        static void expire_at(data_storage_t& storage, expiry_t at) noexcept
+        {
+            storage._expire_at = at;
+        }
+    };
+
+    /** Shorthand for ExpiringValueManager over PlainValueManager */
+    template <class Payload, size_t inline_byte_size_limit = sizeof(vtm::FarAddress)>
+    using PlainExpiringValueManager = ExpiringValueManager<PlainValueManager<Payload, inline_byte_size_limit>>;
+
+    /** Payload manager that keeps expiration point of each value (\sa ExpiringValueManager) */
+    template <class T>
+    concept ExpiringPayloadManager = requires(typename T::data_storage_t & storage, expiry_t at)
+    {
+        { T::expire_at(std::as_const(storage)) } -> std::convertible_to<expiry_t>;
+        T::expire_at(storage, at);
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_EXPIRINGVALUEMANAGER__H_
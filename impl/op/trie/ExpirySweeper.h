@@ -0,0 +1,341 @@
+#pragma once
+
+#ifndef _OP_TRIE_EXPIRYSWEEPER__H_
+#define _OP_TRIE_EXPIRYSWEEPER__H_
+
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <future>
+#include <vector>
+#include <stdexcept>
+
+#include <op/common/ThreadPool.h>
+#include <op/vtm/AppendOnlyLog.h>
+#include <op/vtm/AppendOnlySkipList.h>
+#include <op/trie/ExpiringValueManager.h>
+
+namespace OP::trie
+{
+    /** Single record of ExpiryIndex. Atoms of the key are stored in the same AppendOnlyLog as the index */
+    struct ExpiryEntry
+    {
+        expiry_t _expire_at;
+        vtm::FarAddress _key;
+        std::uint32_t _key_size;
+    };
+
+    /** Query to ExpiryIndex: select entries with expiration point in the interval (_swept, _now] */
+    struct ExpiryQuery
+    {
+        expiry_t _swept;
+        expiry_t _now;
+    };
+
+    /**
+    *   Indexer of AppendOnlySkipList bucket. Keeps range of expiration points of the bucket, so buckets
+    *   that are completely swept or don't contain expired entries yet are skipped without scanning.
+    */
+    struct ExpiryRangeIndexer
+    {
+        expiry_t _min = std::numeric_limits<expiry_t>::max();
+        expiry_t _max = 0;
+
+        template <class T>
+        void index(const T& entry) noexcept
+        {
+            _min = std::min(_min, entry._expire_at);
+            _max = std::max(_max, entry._expire_at);
+        }
+
+        template <class Q>
+        vtm::BucketNavigation check(const Q& query) const noexcept
+        {
+            return (_max <= query._swept || _min > query._now)
+                ? vtm::BucketNavigation::next
+                : vtm::BucketNavigation::worth;
+        }
+    };
+
+    /**
+    *   Persistent index of expiration points over AppendOnlySkipList. Each bucket of skip list plays role of
+    *   the time-wheel slot: its min/max expiration points allow to pick only buckets that have something to sweep.
+    *   Index is append only, so it may keep stale records (entry erased or expiration changed), consumer
+    *   must doublecheck each record against the trie.
+    */
+    class ExpiryIndex
+    {
+        using skip_list_t = vtm::AppendOnlySkipList<
+            vtm::a0l_skip_list_bucket_size, ExpiryEntry, ExpiryRangeIndexer>;
+
+        /** Persisted part of the index: position of skip list and progress of the sweeper */
+        struct Header
+        {
+            Header(vtm::FarAddress list) noexcept
+                : _list(list)
+            {
+            }
+
+            vtm::FarAddress _list;
+            std::atomic<expiry_t> _swept = never_expire_c;
+        };
+
+    public:
+        /** Create new index in the `log`. \return pair of address to reopen index later and index itself */
+        static std::pair<vtm::FarAddress, std::shared_ptr<ExpiryIndex>> create_new(std::shared_ptr<vtm::AppendOnlyLog> log)
+        {
+            auto [list_address, list] = vtm::create_a0_skip_list<ExpiryEntry, ExpiryRangeIndexer>(log);
+            auto [address, header] = log->construct<Header>(list_address);
+            return { address, std::shared_ptr<ExpiryIndex>(new ExpiryIndex(std::move(log), header, std::move(list))) };
+        }
+
+        /** Open index previously created by #create_new at `address` */
+        static std::shared_ptr<ExpiryIndex> open(std::shared_ptr<vtm::AppendOnlyLog> log, vtm::FarAddress address)
+        {
+            auto* header = log->at<Header>(address);
+            auto list = vtm::open_a0_skip_list<ExpiryEntry, ExpiryRangeIndexer>(log, header->_list);
+            return std::shared_ptr<ExpiryIndex>(new ExpiryIndex(std::move(log), header, std::move(list)));
+        }
+
+        /** All records with expiration point up to this value have been processed by the sweeper */
+        expiry_t swept() const noexcept
+        {
+            return _header->_swept.load(std::memory_order_acquire);
+        }
+
+        /** Persist progress of the sweeper, so it is not repeated after reopen */
+        void swept(expiry_t value) noexcept
+        {
+            _header->_swept.store(value, std::memory_order_release);
+        }
+
+        /** Register that `key` expires at `expire_at`. Method is thread safe */
+        template <class AtomString>
+        void add(const AtomString& key, expiry_t expire_at)
+        {
+            using atom_t = typename AtomString::value_type;
+            const auto byte_size = static_cast<vtm::segment_pos_t>(key.size() * sizeof(atom_t));
+            auto [address, buffer] = _log->allocate(byte_size);
+            std::memcpy(buffer, key.data(), byte_size);
+            _list->emplace(ExpiryEntry{ expire_at, address, static_cast<std::uint32_t>(key.size()) });
+        }
+
+        /**
+        *   Enumerate records that match `query` in order they were added.
+        * \tparam Key - string type to restore key;
+        * \param f - callback `bool(Key&& key, expiry_t expire_at)`, returns false to stop enumeration.
+        */
+        template <class Key, class F>
+        void for_each_due(const ExpiryQuery& query, F&& f)
+        {
+            using atom_t = typename Key::value_type;
+            _list->indexed_for_each(query, [&](const ExpiryEntry& entry) -> bool {
+                if (entry._expire_at <= query._swept || entry._expire_at > query._now)
+                    return true;
+                const auto* key = _log->at<atom_t>(entry._key);
+                return f(Key(key, key + entry._key_size), entry._expire_at);
+                });
+        }
+
+    private:
+        ExpiryIndex(std::shared_ptr<vtm::AppendOnlyLog> log, Header* header, std::shared_ptr<skip_list_t> list) noexcept
+            : _log(std::move(log))
+            , _header(header)
+            , _list(std::move(list))
+        {
+        }
+
+        std::shared_ptr<vtm::AppendOnlyLog> _log;
+        Header* _header;
+        std::shared_ptr<skip_list_t> _list;
+    };
+
+    /** Result of single TtlSweeper::sweep call */
+    struct SweepReport
+    {
+        /** Number of keys erased */
+        size_t _erased = 0;
+        /** Number of index records checked (including stale ones) */
+        size_t _checked = 0;
+        /** true when all entries expired at the moment of the pass start are processed */
+        bool _complete = true;
+    };
+
+    /**
+    *   Incremental eraser of expired entries of the trie that uses ExpiringValueManager. Sweeper
+    *   processes ExpiryIndex in passes, each pass is bounded by the expiration point taken at its beginning
+    *   and consists of batches, every batch is erased in its own short transaction. Between the batches
+    *   other writers may proceed. Progress of completed passes is persisted in the ExpiryIndex, so after
+    *   reopen sweeper continues from the last swept point.
+    *
+    *   \tparam TTrie - trie with ExpiringPayloadManager.
+    */
+    template <class TTrie>
+    class TtlSweeper
+    {
+    public:
+        using trie_t = TTrie;
+        using key_t = typename trie_t::key_t;
+        using iterator = typename trie_t::iterator;
+
+        TtlSweeper(std::shared_ptr<trie_t> trie, std::shared_ptr<ExpiryIndex> index) noexcept
+            : _trie(std::move(trie))
+            , _index(std::move(index))
+            , _swept(_index->swept())
+            , _pass_to(_swept)
+        {
+        }
+
+        TtlSweeper(const TtlSweeper&) = delete;
+        TtlSweeper& operator=(const TtlSweeper&) = delete;
+
+        ~TtlSweeper()
+        {
+            stop();
+        }
+
+        /**
+        *   Set expiration point of entry (\sa Trie::expire) and register it in the index, so the entry
+        *   is erased by the sweeper after `expire_at`. When `expire_at` is not later than the bound of
+        *   the current (or last) pass, the record is indexed right after the bound to be picked by the
+        *   next pass.
+        * \return false if `pos` doesn't point to the existing entry.
+        */
+        bool expire(iterator& pos, expiry_t expire_at)
+        {
+            if (!_trie->expire(pos, expire_at))
+                return false;
+            if (expire_at != never_expire_c)
+            {
+                std::shared_lock<std::shared_mutex> bound(_pass_to_lock);
+                _index->add(pos.key(), std::max(expire_at, _pass_to + 1));
+            }
+            return true;
+        }
+
+        /**
+        *   Erase single batch of expired entries.
+        * \param now - expiration point to sweep to, it is taken into account only when new pass starts;
+        * \param batch_limit - max number of index records checked in the single transaction;
+        * \return report where `_complete == false` means that there are more entries to sweep.
+        */
+        SweepReport sweep(expiry_t now = ExpiryClock::now(), size_t batch_limit = 64)
+        {
+            std::lock_guard<std::mutex> guard(_sweep_lock);
+            if (!_in_pass)
+            {
+                std::unique_lock<std::shared_mutex> bound(_pass_to_lock);
+                _pass_to = std::max(now, _swept);
+                _pass_offset = 0;
+                _in_pass = true;
+            }
+            std::vector<key_t> due;
+            size_t skip = _pass_offset;
+            SweepReport report;
+            _index->template for_each_due<key_t>(ExpiryQuery{ _swept, _pass_to }, [&](key_t&& key, expiry_t) -> bool {
+                if (skip)
+                {//processed by previous batch of the same pass
+                    --skip;
+                    return true;
+                }
+                if (due.size() == batch_limit)
+                {
+                    report._complete = false;
+                    return false;
+                }
+                due.emplace_back(std::move(key));
+                return true;
+                });
+
+            auto erase_batch = [&](trie_t& trie) {
+                for (const auto& key : due)
+                {
+                    auto found = trie.find(key);
+                    //skip stale records: key erased or expiration has been prolonged since
+                    if (!found.is_end() && ExpiryClock::is_expired(trie.expiry_of(found), _pass_to))
+                    {
+                        trie.erase(found);
+                        ++report._erased;
+                    }
+                }
+            };
+            if (!due.empty())
+                _trie->apply(erase_batch);
+            report._checked = due.size();
+            _pass_offset += due.size();
+            if (report._complete)
+            {
+                _swept = _pass_to;
+                _index->swept(_swept);
+                _in_pass = false;
+            }
+            return report;
+        }
+
+        /**
+        *   Start background sweeping using `pool`. Each `period` sweeper erases all expired entries by
+        *   batches of `batch_limit`.
+        * \throws std::logic_error if sweeper is already started.
+        */
+        template <class Rep, class Period>
+        void start(OP::utils::ThreadPool& pool, std::chrono::duration<Rep, Period> period, size_t batch_limit = 64)
+        {
+            std::unique_lock<std::mutex> guard(_state_lock);
+            if (_job.valid())
+                throw std::logic_error("sweeper is already started");
+            _stop = false;
+            _job = pool.async([this, period, batch_limit]() {
+                std::unique_lock<std::mutex> state(_state_lock);
+                while (!_stop)
+                {
+                    state.unlock();
+                    while (!sweep(ExpiryClock::now(), batch_limit)._complete && !_stop)
+                        ; //keep sweeping until pass is done
+                    state.lock();
+                    _wake.wait_for(state, period, [this]() { return _stop.load(); });
+                }
+                });
+        }
+
+        /** Stop background sweeping if it was started. Waits until current batch is finished */
+        void stop()
+        {
+            std::future<void> job;
+            {
+                std::unique_lock<std::mutex> guard(_state_lock);
+                _stop = true;
+                job = std::move(_job);
+            }
+            _wake.notify_all();
+            if (job.valid())
+                job.get();
+        }
+
+    private:
+        std::shared_ptr<trie_t> _trie;
+        std::shared_ptr<ExpiryIndex> _index;
+
+        std::mutex _sweep_lock;
+        /** All entries with expiration point up to this value are already processed */
+        expiry_t _swept;
+        /** Bound of the current (or last) pass, changed under exclusive #_pass_to_lock */
+        expiry_t _pass_to;
+        std::shared_mutex _pass_to_lock;
+        size_t _pass_offset = 0;
+        bool _in_pass = false;
+
+        std::mutex _state_lock;
+        std::condition_variable _wake;
+        std::atomic_bool _stop = false;
+        std::future<void> _job;
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_EXPIRYSWEEPER__H_
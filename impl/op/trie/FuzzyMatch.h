@@ -0,0 +1,216 @@
+#pragma once
+
+#ifndef _OP_TRIE_FUZZYMATCH__H_
+#define _OP_TRIE_FUZZYMATCH__H_
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#include <op/common/astr.h>
+
+namespace OP::trie
+{
+    /**
+    *   Levenshtein automaton that accepts strings within `max_edits` insertions, deletions or substitutions
+    * from the query. Automaton is fed by atoms of the key one by one, state of automaton after each atom is
+    * a row of edit-distance matrix. State is stored for each consumed atom, so keys that share prefix
+    * with previously evaluated key are evaluated starting from the first different atom only. This
+    * perfectly matches lexicographic iteration over the Trie, where neighbour keys share most of prefix.
+    *
+    * \tparam AtomString - string-like type of query.
+    */
+    template <class AtomString>
+    struct LevenshteinAutomaton
+    {
+        using atom_string_t = AtomString;
+        using distance_t = std::uint32_t;
+
+        /** Marker of #evaluate result when no prefix of the key is rejected */
+        constexpr static size_t alive_c = std::numeric_limits<size_t>::max();
+
+        struct Evaluation
+        {
+            /** Length of the shortest key prefix that is rejected together with all its extensions,
+            *   or #alive_c if any continuation of the key still can be accepted */
+            size_t _dead_prefix = alive_c;
+            /** true if entire key is within `max_edits` from the query */
+            bool _accept = false;
+        };
+
+        LevenshteinAutomaton(atom_string_t query, size_t max_edits)
+            : _query(std::move(query))
+            , _max_edits(static_cast<distance_t>(max_edits))
+            , _width(_query.size() + 1)
+        {
+            // row for the empty key: distance equals to number of deleted query atoms
+            _rows.reserve(_width * (_query.size() + _max_edits + 1));
+            for (size_t i = 0; i < _width; ++i)
+                _rows.push_back(cap(static_cast<distance_t>(i)));
+        }
+
+        const atom_string_t& query() const noexcept
+        {
+            return _query;
+        }
+
+        size_t max_edits() const noexcept
+        {
+            return _max_edits;
+        }
+
+        /** Run automaton over `key` reusing state of common prefix with previously evaluated key */
+        template <class Key>
+        Evaluation evaluate(const Key& key)
+        {
+            auto kb = std::begin(key);
+            const size_t key_size = static_cast<size_t>(std::distance(kb, std::end(key)));
+            //reuse rows of the common prefix
+            size_t common = std::mismatch(
+                _consumed.begin(), _consumed.end(), kb, std::end(key)).first - _consumed.begin();
+            _consumed.resize(common);
+            _rows.resize(_width * (common + 1));
+
+            Evaluation result;
+            for (size_t depth = 0; ; ++depth)
+            {
+                if (depth >= common && depth > 0 && !alive(depth))
+                { //since row values never decrease there is no way to accept any continuation
+                    result._dead_prefix = depth;
+                    return result;
+                }
+                if (depth == key_size)
+                    break;
+                if (depth >= common)
+                    step(kb[depth]);
+            }
+            result._accept = row(key_size)[_query.size()] <= _max_edits;
+            return result;
+        }
+
+    private:
+        distance_t cap(distance_t d) const noexcept
+        {
+            //values above `_max_edits + 1` are not distinguishable, capping keeps arithmetic safe
+            return std::min(d, static_cast<distance_t>(_max_edits + 1));
+        }
+
+        const distance_t* row(size_t depth) const noexcept
+        {
+            return _rows.data() + depth * _width;
+        }
+
+        bool alive(size_t depth) const noexcept
+        {
+            const distance_t* r = row(depth);
+            return *std::min_element(r, r + _width) <= _max_edits;
+        }
+
+        /** Consume next atom of key and append new row */
+        void step(typename atom_string_t::value_type atom)
+        {
+            const size_t depth = _consumed.size();
+            _consumed.push_back(atom);
+            _rows.resize(_width * (depth + 2));
+            const distance_t* prev = row(depth);
+            distance_t* next = _rows.data() + (depth + 1) * _width;
+            next[0] = cap(prev[0] + 1);
+            for (size_t i = 1; i < _width; ++i)
+            {
+                const distance_t substitution = prev[i - 1] + (_query[i - 1] == atom ? 0 : 1);
+                next[i] = cap(std::min({ substitution, prev[i] + 1, next[i - 1] + 1 }));
+            }
+        }
+
+        const atom_string_t _query;
+        const distance_t _max_edits;
+        const size_t _width;
+        /** atoms of the last evaluated key that have rows in `_rows` */
+        atom_string_t _consumed;
+        /** flat matrix of `(_consumed.size() + 1) * _width` */
+        std::vector<distance_t> _rows;
+    };
+
+    namespace Ingredient
+    {
+        /**
+        *   Ingredient for MixAlgorithmRangeAdapter - iterates only keys within `max_edits` Levenshtein
+        *   distance from the query (\sa Trie::fuzzy_range). As soon as automaton rejects some prefix
+        *   entire subtree below the prefix is skipped with single #lower_bound, so only neighbourhood
+        *   of the query is visited.
+        */
+        template <class AtomString>
+        struct FuzzyMatch
+        {
+            FuzzyMatch(AtomString query, size_t max_edits)
+                : _automaton(std::move(query), max_edits)
+            {
+            }
+
+            template <class Trie>
+            auto _begin(const Trie& trie) const
+            {
+                auto result = trie.begin();
+                settle(trie, result);
+                return result;
+            }
+
+            template <class Trie>
+            void _next(const Trie& trie, typename Trie::iterator& i) const
+            {
+                trie.next(i);
+                settle(trie, i);
+            }
+
+            template <class Trie>
+            void _lower_bound(const Trie& trie, typename Trie::iterator& i, const typename Trie::key_t& key) const
+            {
+                if (trie.in_range(i) && !(i.key() < key))
+                    return; //already there, never move backward
+                i = trie.lower_bound(key);
+                settle(trie, i);
+            }
+
+        private:
+            /** Move `i` forward until it points to the accepted key or end */
+            template <class Trie>
+            void settle(const Trie& trie, typename Trie::iterator& i) const
+            {
+                while (trie.in_range(i))
+                {
+                    const auto& key = i.key();
+                    auto eval = _automaton.evaluate(key);
+                    if (eval._dead_prefix != automaton_t::alive_c)
+                    { //skip all keys that start with rejected prefix
+                        typename Trie::key_t successor(key.begin(), key.begin() + eval._dead_prefix);
+                        while (!successor.empty() && successor.back() == std::numeric_limits<
+                            typename Trie::key_t::value_type>::max())
+                            successor.pop_back();
+                        if (successor.empty())
+                        {
+                            i = trie.end();
+                            return;
+                        }
+                        ++successor.back();
+                        i = trie.lower_bound(successor);
+                        continue;
+                    }
+                    if (eval._accept)
+                        return;
+                    trie.next(i);
+                }
+            }
+
+            using automaton_t = LevenshteinAutomaton<AtomString>;
+            /** Mutable since it is a cache of automaton states, each sequence owns own copy of ingredient */
+            mutable automaton_t _automaton;
+        };
+
+        template <class AtomString> //deduction guide
+        FuzzyMatch(AtomString, size_t) -> FuzzyMatch<AtomString>;
+    }//ns:Ingredient
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_FUZZYMATCH__H_
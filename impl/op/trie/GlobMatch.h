@@ -0,0 +1,344 @@
+#pragma once
+
+#ifndef _OP_TRIE_GLOBMATCH__H_
+#define _OP_TRIE_GLOBMATCH__H_
+
+#include <vector>
+#include <algorithm>
+#include <cassert>
+#include <array>
+#include <map>
+#include <limits>
+#include <stdexcept>
+#include <cstdint>
+
+#include <op/common/astr.h>
+#include <op/common/Bitset.h>
+
+namespace OP::trie
+{
+    /**
+    *   Deterministic automaton compiled from glob pattern. Supported syntax:
+    *   \li `*` - any (including empty) sequence of atoms;
+    *   \li `?` - exactly one arbitrary atom;
+    *   \li `[abc]`, `[a-z]` - one atom from the set or range, `[!a-z]` or `[^a-z]` - one atom out of the set;
+    *   \li `\` - escapes next atom, so `\*` matches asterisk;
+    *   \li any other atom matches itself.
+    *
+    *   DFA states are built lazily (subset construction over positions of the pattern) on the first
+    * transition, so only states reachable by the keys of the trie are ever materialized.
+    */
+    class GlobAutomaton
+    {
+    public:
+        using atom_t = OP::common::atom_t;
+        /** Set of atoms, the same bitset as used for presence of entries in the trie node */
+        using atom_set_t = OP::common::Bitset<4, std::uint64_t>;
+        using state_t = std::uint32_t;
+
+        /** State that rejects any continuation */
+        constexpr static state_t dead_c = std::numeric_limits<state_t>::max();
+
+        /**
+        *   \param pattern - glob pattern, any string of atoms that supports std::begin / std::end iteration
+        *   \throws std::invalid_argument if pattern is malformed (unclosed `[` or trailing `\`)
+        */
+        template <class AtomString>
+        explicit GlobAutomaton(const AtomString& pattern)
+        {
+            compile(std::begin(pattern), std::end(pattern));
+            std::vector<bool> initial(_tokens.size() + 1, false);
+            initial[0] = true;
+            _start = materialize(closure(std::move(initial)));
+        }
+
+        state_t start() const noexcept
+        {
+            return _start;
+        }
+
+        /** \return state after consuming `atom` in `state` or #dead_c */
+        state_t step(state_t state, atom_t atom)
+        {
+            assert(state != dead_c);
+            state_t next = _states[state]._transitions[atom];
+            if (next == unknown_c)
+            {
+                const auto& positions = _states[state]._positions;
+                std::vector<bool> moved(_tokens.size() + 1, false);
+                bool any = false;
+                for (size_t i = 0; i < _tokens.size(); ++i)
+                {
+                    if (!positions[i] || !_tokens[i]._atoms.get(atom))
+                        continue;
+                    //star keeps position, others advance
+                    moved[_tokens[i]._star ? i : i + 1] = true;
+                    any = true;
+                }
+                next = any ? materialize(closure(std::move(moved))) : dead_c;
+                _states[state]._transitions[atom] = next;
+            }
+            return next;
+        }
+
+        /** \return true if key that leads to `state` matches entire pattern */
+        bool accepting(state_t state) const noexcept
+        {
+            return state != dead_c && _states[state]._accepting;
+        }
+
+        /** \return set of atoms that don't lead to #dead_c from `state` */
+        const atom_set_t& allowed(state_t state) const noexcept
+        {
+            assert(state != dead_c);
+            return _states[state]._allowed;
+        }
+
+    private:
+        constexpr static state_t unknown_c = dead_c - 1;
+
+        struct Token
+        {
+            atom_set_t _atoms;
+            bool _star = false;
+        };
+
+        struct State
+        {
+            std::vector<bool> _positions;
+            bool _accepting = false;
+            /** union of atoms accepted by tokens at `_positions` */
+            atom_set_t _allowed;
+            std::array<state_t, 256> _transitions;
+        };
+
+        template <class AtomIterator>
+        void compile(AtomIterator begin, AtomIterator end)
+        {
+            auto escaped = [&]() -> atom_t {
+                if (++begin == end)
+                    throw std::invalid_argument("glob pattern must not end with escape");
+                return static_cast<atom_t>(*begin);
+            };
+            for (; begin != end; ++begin)
+            {
+                Token token;
+                const atom_t c = static_cast<atom_t>(*begin);
+                switch (c)
+                {
+                case '*':
+                    if (!_tokens.empty() && _tokens.back()._star)
+                        continue; //sequence of stars is the same as single star
+                    token._star = true;
+                    set_range(token._atoms, 0, 255);
+                    break;
+                case '?':
+                    set_range(token._atoms, 0, 255);
+                    break;
+                case '[':
+                {
+                    if (++begin == end)
+                        throw std::invalid_argument("unclosed '[' in glob pattern");
+                    bool negate = false;
+                    if (*begin == '!' || *begin == '^')
+                    {
+                        negate = true;
+                        ++begin;
+                    }
+                    atom_set_t atoms;
+                    //`]` just after opening is treated as a regular atom
+                    for (bool first = true; ; first = false)
+                    {
+                        if (begin == end)
+                            throw std::invalid_argument("unclosed '[' in glob pattern");
+                        atom_t from = static_cast<atom_t>(*begin);
+                        if (from == ']' && !first)
+                            break;
+                        if (from == '\\')
+                            from = escaped();
+                        atom_t to = from;
+                        auto look_ahead = begin;
+                        if (++look_ahead != end && *look_ahead == '-')
+                        {
+                            auto range_end = look_ahead;
+                            if (++range_end != end && *range_end != ']')
+                            {
+                                begin = range_end;
+                                to = static_cast<atom_t>(*begin);
+                                if (to == '\\')
+                                    to = escaped();
+                                if (to < from)
+                                    throw std::invalid_argument("invalid range in glob pattern");
+                            }
+                        }
+                        set_range(atoms, from, to);
+                        ++begin;
+                    }
+                    if (negate)
+                        for (unsigned i = 0; i < 256; ++i)
+                            atoms.get(i) ? atoms.clear(i) : atoms.set(i);
+                    token._atoms = atoms;
+                    break;
+                }
+                case '\\':
+                    token._atoms.set(escaped());
+                    break;
+                default:
+                    token._atoms.set(c);
+                }
+                _tokens.push_back(token);
+            }
+        }
+
+        static void set_range(atom_set_t& atoms, unsigned from, unsigned to)
+        {
+            for (; from <= to; ++from)
+                atoms.set(from);
+        }
+
+        /** Add positions reachable without consuming atoms (star matches empty sequence) */
+        std::vector<bool> closure(std::vector<bool> positions) const
+        {
+            for (size_t i = 0; i < _tokens.size(); ++i)
+                if (positions[i] && _tokens[i]._star)
+                    positions[i + 1] = true;
+            return positions;
+        }
+
+        state_t materialize(std::vector<bool> positions)
+        {
+            auto found = _index.find(positions);
+            if (found != _index.end())
+                return found->second;
+            State state;
+            state._accepting = positions[_tokens.size()];
+            for (size_t i = 0; i < _tokens.size(); ++i)
+                if (positions[i])
+                    state._allowed = state._allowed | _tokens[i]._atoms;
+            state._transitions.fill(unknown_c);
+            state._positions = positions;
+            const auto id = static_cast<state_t>(_states.size());
+            _states.emplace_back(std::move(state));
+            _index.emplace(std::move(positions), id);
+            return id;
+        }
+
+        std::vector<Token> _tokens;
+        std::vector<State> _states;
+        std::map<std::vector<bool>, state_t> _index;
+        state_t _start = dead_c;
+    };
+
+    namespace Ingredient
+    {
+        /**
+        *   Ingredient for MixAlgorithmRangeAdapter - iterates only keys that match glob pattern
+        *   (\sa Trie::match_range). Automaton runs along the key of current position, as soon as some atom
+        *   is rejected iteration seeks directly to the smallest atom allowed by the automaton at this
+        *   depth, or skips entire subtree if there is no such atom.
+        */
+        struct GlobMatch
+        {
+            explicit GlobMatch(GlobAutomaton automaton) noexcept
+                : _automaton(std::move(automaton))
+            {
+            }
+
+            template <class Trie>
+            auto _begin(const Trie& trie) const
+            {
+                auto result = trie.begin();
+                settle(trie, result);
+                return result;
+            }
+
+            template <class Trie>
+            void _next(const Trie& trie, typename Trie::iterator& i) const
+            {
+                trie.next(i);
+                settle(trie, i);
+            }
+
+            template <class Trie>
+            void _lower_bound(const Trie& trie, typename Trie::iterator& i, const typename Trie::key_t& key) const
+            {
+                if (trie.in_range(i) && !(i.key() < key))
+                    return; //already there, never move backward
+                i = trie.lower_bound(key);
+                settle(trie, i);
+            }
+
+        private:
+            /** Move `i` forward until it points to the matching key or end */
+            template <class Trie>
+            void settle(const Trie& trie, typename Trie::iterator& i) const
+            {
+                using key_t = typename Trie::key_t;
+                while (trie.in_range(i))
+                {
+                    const auto& key = i.key();
+                    size_t depth = evaluate(key);
+                    if (depth == key.size())
+                    {
+                        if (_automaton.accepting(_states.back()))
+                            return;
+                        trie.next(i);
+                        continue;
+                    }
+                    //atom at `depth` is rejected, look for the nearest allowed one
+                    key_t target(key.begin(), key.begin() + depth);
+                    const auto& allowed = _automaton.allowed(_states[depth]);
+                    auto next_atom = allowed.next_set(key[depth]);
+                    if (next_atom != GlobAutomaton::atom_set_t::nil_c)
+                        target.push_back(static_cast<atom_t>(next_atom));
+                    else
+                    { //no way from this prefix, skip subtree
+                        while (!target.empty() && target.back() == std::numeric_limits<atom_t>::max())
+                            target.pop_back();
+                        if (target.empty())
+                        {
+                            i = trie.end();
+                            return;
+                        }
+                        ++target.back();
+                    }
+                    trie.next_lower_bound_of(i, target);
+                }
+            }
+
+            /** Run automaton along `key` reusing states of the common prefix with previous key
+            * \return length of accepted prefix, equals to key size if all atoms are accepted
+            */
+            template <class Key>
+            size_t evaluate(const Key& key) const
+            {
+                if (_states.empty())
+                    _states.push_back(_automaton.start());
+                size_t common = std::mismatch(
+                    _consumed.begin(), _consumed.end(), key.begin(), key.end()).first - _consumed.begin();
+                _consumed.resize(common);
+                _states.resize(common + 1);
+                for (size_t depth = common; depth < key.size(); ++depth)
+                {
+                    auto next = _automaton.step(_states.back(), key[depth]);
+                    if (next == GlobAutomaton::dead_c)
+                        return depth;
+                    _consumed.push_back(key[depth]);
+                    _states.push_back(next);
+                }
+                return key.size();
+            }
+
+            using atom_t = OP::common::atom_t;
+
+            /** Mutable since automaton lazily builds DFA and caches path, each sequence owns own copy of ingredient */
+            mutable GlobAutomaton _automaton;
+            mutable OP::common::atom_string_t _consumed;
+            /** `_states[d]` is a state after consuming `d` atoms of `_consumed` */
+            mutable std::vector<GlobAutomaton::state_t> _states;
+        };
+    }//ns:Ingredient
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_GLOBMATCH__H_
@@ -55,7 +55,7 @@ namespace OP::trie::containers
                 return 256;
             }
         };
-        
+
         /**function forms bit-mask to evaluate hash. It is assumed that param capacity is ^2 */
         constexpr inline dim_t bitmask(dim_t capacity) noexcept
         {
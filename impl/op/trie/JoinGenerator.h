@@ -5,6 +5,13 @@
 #include <op/flur/Sequence.h>
 #include <op/flur/Conditional.h>
 #include <op/flur/typedefs.h>
+#include <op/flur/LazyRange.h>
+#include <op/common/astr.h>
+#include <op/common/LexComparator.h>
+
+#include <memory>
+#include <tuple>
+#include <stdexcept>
 
 namespace opfd = OP::flur::details;
 namespace details
@@ -226,4 +233,286 @@ namespace OP::flur::then
     }
 
 } //ns: OP::flur::then
+
+/**
+*   Participant of #LeapfrogJoin backed by the Trie. Seek is done by #Trie::next_lower_bound_of so 
+*   iterator never moves backward and reuses already resolved prefix.
+*/
+template <class Trie>
+struct LeapfrogTrieParticipant
+{
+    using key_t = typename Trie::key_t;
+
+    explicit LeapfrogTrieParticipant(std::shared_ptr<Trie const> trie) noexcept
+        : _trie(std::move(trie))
+    {
+    }
+
+    void start()
+    {
+        _position = _trie->begin();
+    }
+
+    bool in_range() const
+    {
+        return _trie->in_range(_position);
+    }
+
+    void next()
+    {
+        _trie->next(_position);
+    }
+
+    /** Move forward to the first key that is not less than `key` */
+    template <class Key>
+    void seek(const Key& key)
+    {
+        if (in_range() && compare(key) < 0)
+            _trie->next_lower_bound_of(_position, key);
+    }
+
+    /** \return <0, 0, >0 if current key is less, equal or greater than `key` */
+    template <class Key>
+    int compare(const Key& key) const
+    {
+        const auto& current = _position.key();
+        auto lb = std::begin(current);
+        auto rb = std::begin(key);
+        return OP::common::str_lexico_comparator(lb, std::end(current), rb, std::end(key));
+    }
+
+    template <class Key>
+    void assign_to(Key& key) const
+    {
+        const auto& current = _position.key();
+        key.assign(std::begin(current), std::end(current));
+    }
+
+private:
+    std::shared_ptr<Trie const> _trie;
+    typename Trie::iterator _position;
+};
+
+/**
+*   Participant of #LeapfrogJoin backed by the ordered flur sequence of string-like elements. Sequence has
+*   no random access, so seek is done by linear advancing.
+*/
+template <class Seq>
+struct LeapfrogSequenceParticipant
+{
+    explicit LeapfrogSequenceParticipant(Seq&& seq) noexcept
+        : _seq(std::move(seq))
+    {
+    }
+
+    void start()
+    {
+        auto& seq = opfd::get_reference(_seq);
+        if (!seq.is_sequence_ordered())
+            throw std::runtime_error("unordered input sequence");
+        seq.start();
+    }
+
+    bool in_range() const
+    {
+        return opfd::get_reference(_seq).in_range();
+    }
+
+    void next()
+    {
+        opfd::get_reference(_seq).next();
+    }
+
+    template <class Key>
+    void seek(const Key& key)
+    {
+        auto& seq = opfd::get_reference(_seq);
+        for (; seq.in_range() && compare(key) < 0; seq.next())
+        {/*skip*/}
+    }
+
+    template <class Key>
+    int compare(const Key& key) const
+    {
+        decltype(auto) current = opfd::get_reference(_seq).current();
+        auto lb = std::begin(current);
+        auto rb = std::begin(key);
+        return OP::common::str_lexico_comparator(lb, std::end(current), rb, std::end(key));
+    }
+
+    template <class Key>
+    void assign_to(Key& key) const
+    {
+        decltype(auto) current = opfd::get_reference(_seq).current();
+        key.assign(std::begin(current), std::end(current));
+    }
+
+private:
+    Seq _seq;
+};
+
+/**
+*   N-way intersection of the keys (leapfrog join). Participants are visited round robin, each one
+*   seeks to the current candidate - the greatest key seen so far. When participant lands on a greater key
+*   this key becomes the new candidate, as soon as all participants in a row land exactly on the candidate
+*   it is emitted. Since each participant only moves forward, complexity is bounded by the size of the
+*   smallest participant multiplied by cost of seek.
+*
+*   \tparam Key - type of resulting key;
+*   \tparam Participants - #LeapfrogTrieParticipant or #LeapfrogSequenceParticipant.
+*/
+template <class Key, class ... Participants>
+struct LeapfrogJoin : OP::flur::OrderedSequence<const Key&>
+{
+    static_assert(sizeof...(Participants) > 0, "at least one participant must be specified");
+
+    using base_t = OP::flur::OrderedSequence<const Key&>;
+    using element_t = typename base_t::element_t;
+
+    explicit LeapfrogJoin(std::tuple<Participants...> participants) noexcept
+        : _participants(std::move(participants))
+    {
+    }
+
+    void start() override
+    {
+        std::apply([](auto& ...p) { (p.start(), ...); }, _participants);
+        _candidate.clear();
+        _in_range = true;
+        seek();
+    }
+
+    bool in_range() const override
+    {
+        return _in_range;
+    }
+
+    element_t current() const override
+    {
+        return _candidate;
+    }
+
+    void next() override
+    {
+        auto& leader = std::get<0>(_participants);
+        leader.next();
+        if (!leader.in_range())
+        {
+            _in_range = false;
+            return;
+        }
+        leader.assign_to(_candidate);
+        seek();
+    }
+
+private:
+    void seek()
+    {
+        size_t matched = 0;
+        bool stop = false;
+        while (!stop)
+        {
+            stop = std::apply([&](auto& ...p) {
+                return (visit(p, matched) || ...);
+                }, _participants);
+        }
+    }
+
+    /** \return true when iteration must stop: either all participants agree on candidate or some is exhausted */
+    template <class Participant>
+    bool visit(Participant& participant, size_t& matched)
+    {
+        participant.seek(_candidate);
+        if (!participant.in_range())
+        {
+            _in_range = false;
+            return true;
+        }
+        if (participant.compare(_candidate) > 0)
+        {
+            participant.assign_to(_candidate);
+            matched = 0;
+        }
+        return ++matched == sizeof...(Participants);
+    }
+
+    std::tuple<Participants...> _participants;
+    Key _candidate;
+    bool _in_range = false;
+};
+
+namespace details
+{
+    /** Key type of #LeapfrogJoin is taken from the first Trie among participants */
+    template <class ... Tx>
+    struct leapfrog_key
+    {
+        using type = OP::common::atom_string_t;
+    };
+
+    template <class Trie, class ... Tx>
+    struct leapfrog_key<std::shared_ptr<Trie>, Tx...>
+    {
+        using type = typename std::decay_t<Trie>::key_t;
+    };
+
+    template <class T, class ... Tx>
+    struct leapfrog_key<T, Tx...> : leapfrog_key<Tx...>
+    {
+    };
+
+    template <class Trie>
+    auto make_leapfrog_participant(const std::shared_ptr<Trie>& trie)
+    {
+        using trie_t = std::remove_const_t<Trie>;
+        return LeapfrogTrieParticipant<trie_t>(std::const_pointer_cast<trie_t const>(trie));
+    }
+
+    template <class Factory>
+    auto make_leapfrog_participant(const Factory& factory)
+    {
+        static_assert(std::is_base_of_v<OP::flur::FactoryBase, Factory>,
+            "participant must be either std::shared_ptr of Trie or flur factory");
+        return LeapfrogSequenceParticipant<std::decay_t<decltype(factory.compound())>>(factory.compound());
+    }
+}//ns:details
+
+template <class ... Sources>
+struct LeapfrogJoinFactory : OP::flur::FactoryBase
+{
+    using key_t = typename ::details::leapfrog_key<Sources...>::type;
+
+    explicit LeapfrogJoinFactory(Sources ... sources) noexcept
+        : _sources(std::move(sources)...)
+    {
+    }
+
+    auto compound() const
+    {
+        return std::apply([](const auto& ...src) {
+            return LeapfrogJoin<key_t, decltype(::details::make_leapfrog_participant(src))...>(
+                std::make_tuple(::details::make_leapfrog_participant(src)...));
+            }, _sources);
+    }
+
+private:
+    std::tuple<Sources...> _sources;
+};
+
+namespace OP::flur::src
+{
+    /**
+    *   Produce ordered range of keys that present in all of the sources (leapfrog join). Each source is either
+    *   `std::shared_ptr` of Trie or ordered flur range of string-like elements (for example 
+    *   `src::of_container(std::set<atom_string_t>{...})`), sources are expected to be strictly ordered. 
+    *   Unlike `then::prefix_join` keys are matched exactly, not by prefix.
+    *   \throws std::runtime_error at iteration start if some flur source is not ordered.
+    */
+    template <class ... Sources>
+    auto leapfrog_join(Sources&& ... sources) noexcept
+    {
+        return make_lazy_range(LeapfrogJoinFactory<std::decay_t<Sources>...>(
+            std::forward<Sources>(sources)...));
+    }
+} //ns: OP::flur::src
 #endif //_OP_TRIE_JoinOrderedSequenceWithTrie__H_
@@ -0,0 +1,257 @@
+#pragma once
+
+#ifndef _OP_TRIE_MEMBERSHIPFILTER__H_
+#define _OP_TRIE_MEMBERSHIPFILTER__H_
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+#include <op/vtm/SegmentManager.h>
+#include <op/vtm/SegmentTopology.h>
+#include <op/vtm/slots/HeapManager.h>
+#include <op/trie/TrieResidence.h>
+
+namespace OP::trie
+{
+    /**
+    *   Persistent blocked Bloom filter that answers "definitely absent" for most of the missing keys
+    *   without navigation over the trie nodes. Slot resides in 0 segment next to TrieResidence and keeps
+    *   only FilterHeader, the blocks are allocated by HeapManagerSlot.
+    *
+    *   Filter consists of blocks of 512 bits (size of the cache line), key is hashed once to select the
+    *   block and all #hash_count_c bits are set/tested inside this single block. Number of blocks is
+    *   chosen from the expected number of keys (\sa #fit_block_count), so false positive rate stays below
+    *   ~1% while the number of keys doesn't exceed #capacity. Filter doesn't track number of keys itself,
+    *   the owning Trie counts them in TrieResidence and #reset the filter of bigger size when the
+    *   capacity is exceeded. Blocks must fit single heap allocation, so after the filter reaches
+    *   #max_block_count it stops growing and false positive rate rises with the number of keys.
+    *   Slot is present only in the topology of Trie with TrieFeature::membership_filter.
+    *   Bits are modified in the scope of the same transaction as the trie, so rollback of the trie
+    *   changes rolls back the filter as well.
+    *
+    *   Bloom filter cannot forget keys, erased keys stay in the filter until #Trie::rebuild_filter is called.
+    *   Stale keys never produce wrong answer, but increase rate of false positives (\sa Trie::filter_stale_count).
+    */
+    struct MembershipFilter : public vtm::Slot
+    {
+        using FarAddress = vtm::FarAddress;
+        using segment_idx_t = vtm::segment_idx_t;
+        using segment_pos_t = vtm::segment_pos_t;
+
+        /** Smallest number of 512-bit blocks in the filter */
+        constexpr static segment_pos_t min_block_count_c = 16;
+        /** Number of keys per block that keeps false positive rate below ~1% */
+        constexpr static std::uint64_t keys_per_block_c = 40;
+        /** Number of bits set for each key inside the block */
+        constexpr static unsigned hash_count_c = 6;
+
+        /** Block of the filter, has size of the single cache line */
+        struct Block
+        {
+            std::uint64_t _bits[8];
+        };
+
+        /** Plain data structure to store state of filter */
+        struct FilterHeader
+        {
+            /** Array of #_block_count blocks allocated by HeapManagerSlot, nil until the first #reset */
+            FarAddress _blocks = {};
+            /** Number of blocks in #_blocks */
+            segment_pos_t _block_count = 0;
+        };
+
+        template <class TSegmentManager, class Payload, class TKeyString, std::uint32_t initial_node_count, TrieFeature features>
+        friend struct Trie;
+
+        explicit MembershipFilter(vtm::SegmentManager& manager) noexcept
+            : Slot(manager)
+        {
+        }
+
+        FilterHeader get_header() const
+        {
+            return *vtm::view<FilterHeader>(segment_manager(), _segment_address);
+        }
+
+        /** \return number of keys the filter may hold keeping the designed false positive rate */
+        std::uint64_t capacity() const
+        {
+            return get_header()._block_count * keys_per_block_c;
+        }
+
+        /** \return true if filter may be #reset to bigger number of blocks */
+        bool can_grow() const
+        {
+            return get_header()._block_count < max_block_count(segment_manager().segment_size());
+        }
+
+        /**
+        *   Check if key may present in the filter. Reads exactly one block.
+        * \param begin, end - range of atoms of the key
+        * \return false if key was never added since the last rebuild, true if key may present.
+        */
+        template <class Atom>
+        bool might_contain(Atom begin, Atom end) const
+        {
+            const auto header = get_header();
+            if (header._blocks.is_nil())
+                return true; //filter is not populated yet
+            const auto h = hash(begin, end);
+            auto block = vtm::view<Block>(segment_manager(), block_address(header, h));
+            std::uint64_t probe = mix(h);
+            for (unsigned i = 0; i < hash_count_c; ++i, probe >>= 9)
+            {
+                const auto bit = probe & 511;
+                if (!(block->_bits[bit >> 6] & (std::uint64_t{ 1 } << (bit & 63))))
+                    return false;
+            }
+            return true;
+        }
+
+        template <class AtomString>
+        bool might_contain(const AtomString& key) const
+        {
+            return might_contain(std::begin(key), std::end(key));
+        }
+
+    protected:
+        /**
+        *   Add key to the filter, modifies exactly one block. Must be called in transaction scope after the
+        *   filter has been populated by #reset.
+        */
+        template <class AtomString>
+        void add(const AtomString& key)
+        {
+            const auto header = get_header();
+            assert(!header._blocks.is_nil());
+            const auto h = hash(std::begin(key), std::end(key));
+            auto block = vtm::accessor<Block>(segment_manager(), block_address(header, h));
+            std::uint64_t probe = mix(h);
+            for (unsigned i = 0; i < hash_count_c; ++i, probe >>= 9)
+            {
+                const auto bit = probe & 511;
+                block->_bits[bit >> 6] |= std::uint64_t{ 1 } << (bit & 63);
+            }
+        }
+
+        /**
+        *   Forget all keys and size the filter for `expected_keys`. Blocks are re-allocated only when the
+        *   number of them changes. Must be called in transaction scope.
+        */
+        void reset(vtm::HeapManagerSlot& heap, std::uint64_t expected_keys)
+        {
+            auto header = get_header();
+            const auto block_count = fit_block_count(expected_keys, segment_manager().segment_size());
+            const auto bytes = static_cast<segment_pos_t>(sizeof(Block) * block_count);
+            auto hint = OP::vtm::WritableBlockHint::update_c;
+            if (block_count != header._block_count)
+            {
+                if (!header._blocks.is_nil())
+                    heap.deallocate(header._blocks);
+                header._blocks = heap.allocate(bytes);
+                header._block_count = block_count;
+                *vtm::accessor<FilterHeader>(segment_manager(), _segment_address) = header;
+                hint = OP::vtm::WritableBlockHint::new_c;
+            }
+            auto wr = segment_manager().writable_block(header._blocks, bytes, hint);
+            std::memset(wr.pos(), 0, bytes);
+        }
+
+        /**
+        *   \return power of 2 number of blocks enough to keep `expected_keys`, but not less than
+        *   #min_block_count_c and not more than #max_block_count.
+        */
+        static segment_pos_t fit_block_count(std::uint64_t expected_keys, segment_pos_t segment_size) noexcept
+        {
+            const std::uint64_t max_blocks = max_block_count(segment_size);
+            std::uint64_t result = min_block_count_c;
+            while (result * keys_per_block_c < expected_keys && result * 2 <= max_blocks)
+                result *= 2;
+            return static_cast<segment_pos_t>(result);
+        }
+
+        /**
+        *   Blocks must fit single heap allocation, so their number is limited by power of 2 that fits
+        *   quarter of `segment_size`.
+        */
+        static segment_pos_t max_block_count(segment_pos_t segment_size) noexcept
+        {
+            return static_cast<segment_pos_t>(std::max<std::uint64_t>(
+                min_block_count_c, std::bit_floor(std::uint64_t{ segment_size } / 4 / sizeof(Block))));
+        }
+
+        //
+        //  Overrides
+        //
+        /**Slot resides in zero-segment only*/
+        bool has_residence(segment_idx_t segment_idx) const override
+        {
+            return segment_idx == 0;
+        }
+
+        /**Reserve enough to keep FilterHeader*/
+        segment_pos_t byte_size(FarAddress segment_address) const override
+        {
+            assert(segment_address.segment() == 0);
+            return vtm::memory_requirement<FilterHeader>::requirement;
+        }
+
+        void on_new_segment(FarAddress segment_address) override
+        {
+            assert(segment_address.segment() == 0);
+            _segment_address = segment_address;
+            *segment_manager().wr_at<FilterHeader>(segment_address, OP::vtm::WritableBlockHint::new_c)
+                = FilterHeader(); //no blocks until Trie populates the filter
+        }
+
+        void open(FarAddress segment_address) override
+        {
+            assert(segment_address.segment() == 0);
+            _segment_address = segment_address;
+        }
+
+        void release_segment(segment_idx_t segment_index) override
+        {
+            /* do nothing */
+        }
+
+    private:
+        /** FNV-1a over atoms of the key */
+        template <class Atom>
+        static std::uint64_t hash(Atom begin, Atom end) noexcept
+        {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            for (; begin != end; ++begin)
+            {
+                h ^= static_cast<std::uint8_t>(*begin);
+                h *= 0x100000001b3ull;
+            }
+            return h;
+        }
+
+        /** splitmix64 finalizer, gives independent bits to choose positions inside the block */
+        static std::uint64_t mix(std::uint64_t h) noexcept
+        {
+            h ^= h >> 30;
+            h *= 0xbf58476d1ce4e5b9ull;
+            h ^= h >> 27;
+            h *= 0x94d049bb133111ebull;
+            h ^= h >> 31;
+            return h;
+        }
+
+        static FarAddress block_address(const FilterHeader& header, std::uint64_t h) noexcept
+        {
+            const auto index = static_cast<segment_pos_t>(((h >> 32) * header._block_count) >> 32);
+            return header._blocks + static_cast<segment_pos_t>(sizeof(Block) * index);
+        }
+
+        FarAddress _segment_address;
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_MEMBERSHIPFILTER__H_
@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <functional>
+#include <optional>
 #include <type_traits>
 #include <op/common/astr.h>
 #include <op/common/has_member_def.h>
@@ -140,6 +141,40 @@ namespace OP::trie
         template <class AtomString> //deduction guide
         PrefixedBegin(AtomString) -> PrefixedBegin<AtomString>;
 
+        /** Ingredient for MixAlgorithmRangeAdapter - allows start descending iteration from the last element 
+        * that matches specific prefix string */
+        template <class AtomString>
+        struct PrefixedLast
+        {
+
+            constexpr explicit PrefixedLast(AtomString prefix) noexcept
+                : _prefix(std::move(prefix))
+            {
+            }
+
+            template <class Trie>
+            auto _begin(const Trie& trie) const
+            {
+                return trie.prefixed_last(std::begin(_prefix), std::end(_prefix));
+            }
+
+        private:
+            const std::decay_t<AtomString> _prefix;
+        };
+
+        template <class AtomString> //deduction guide
+        PrefixedLast(AtomString) -> PrefixedLast<AtomString>;
+
+        /** Ingredient for MixAlgorithmRangeAdapter - allows range use `prev` method instead of `next` */
+        struct PrevNext
+        {
+            template <class Trie>
+            void _next(const Trie& trie, typename Trie::iterator& i) const
+            {
+                trie.prev(i);
+            }
+        };
+
         /** Ingredient for MixAlgorithmRangeAdapter - allows start iteration from first element that 
         greater or equal than specific key. If key is not started with prefix:
             - for lexicographic less key - then lower_bound starts from prefix
@@ -185,6 +220,48 @@ namespace OP::trie
         template <class AtomString> //deduction guide
         PrefixedLowerBound(AtomString) -> PrefixedLowerBound<AtomString>;
 
+        /** Ingredient for MixAlgorithmRangeAdapter - restricts iteration by half-open interval of keys 
+        * `[from, to)`. Upper bound is optional, when it is absent range continues till the end of trie.
+        */
+        template <class AtomString>
+        struct KeyInterval
+        {
+            KeyInterval(AtomString from, std::optional<AtomString> to) noexcept
+                : _from(std::move(from))
+                , _to(std::move(to))
+            {
+            }
+
+            template <class Trie>
+            auto _begin(const Trie& trie) const
+            {
+                //trie never keeps empty key, so empty lower bound means beginning of the trie
+                return std::empty(_from) ? trie.begin() : trie.lower_bound(_from);
+            }
+
+            template <class Trie>
+            bool _in_range(const Trie& trie, const typename Trie::iterator& i) const
+            {
+                return trie.in_range(i) && (!_to || std::lexicographical_compare(
+                    i.key().begin(), i.key().end(), std::begin(*_to), std::end(*_to)));
+            }
+
+            /** \param i - [out] result iterator, never goes below the lower bound of interval */
+            template <class Trie>
+            void _lower_bound(const Trie& trie, typename Trie::iterator& i, const typename Trie::key_t& key) const
+            {
+                if (std::empty(key) ||
+                    std::lexicographical_compare(std::begin(key), std::end(key), std::begin(_from), std::end(_from)))
+                    i = _begin(trie);
+                else
+                    i = trie.lower_bound(key);
+            }
+
+        private:
+            const AtomString _from;
+            const std::optional<AtomString> _to;
+        };
+
         /** Ingredient for MixAlgorithmRangeAdapter - allows range customize `in_range` in a way to check that 
         * range iterates over items with specific prefix 
         * \tparam F should be `bool(const iterator&)`
@@ -426,6 +503,53 @@ namespace OP::trie
         mixer_iterator_t _pos;
     };
 
+    /**
+    *   flur library adapter for descending iteration over Trie. In compare with TrieSequence 
+    *  it is not an OrderedSequence since all flur ordered algorithms assume ascending order.
+    *  Mixer must provide ingredients for descending `_begin` and `_next` (for example 
+    *  Ingredient::PrefixedLast and Ingredient::PrevNext).
+    */
+    template <class TTrie, class ... Mx>
+    struct ReverseTrieSequence : public flur::Sequence< const typename TTrie::iterator& >
+    {
+        using trie_t = TTrie;
+        using mixer_t = Mixer<trie_t, Mx ...>;
+        using mixer_iterator_t = typename trie_t::iterator;
+
+        ReverseTrieSequence(std::shared_ptr<const trie_t> parent, mixer_t mixer) noexcept
+            : _parent(std::move(parent))
+            , _mixer(std::move(mixer))
+        {
+        }
+
+        virtual void start() override
+        {
+            _pos = _mixer._begin(*_parent);
+        }
+
+        virtual bool in_range() const override
+        {
+            if(_pos.is_end())
+                return false;
+            return _mixer._in_range(*_parent, _pos );
+        }
+
+        virtual const mixer_iterator_t& current() const override
+        {
+            return _pos;
+        }
+
+        virtual void next() override
+        {
+            return _mixer._next(*_parent, _pos);
+        }
+
+    private:
+        std::shared_ptr<const trie_t> _parent;
+        mixer_t _mixer;
+        mixer_iterator_t _pos;
+    };
+
     template <class TTrie, class ... Mx>
     struct TrieSequenceFactory : OP::flur::FactoryBase
     {
@@ -452,6 +576,32 @@ namespace OP::trie
         mixer_t _mixer;
     };
 
+    template <class TTrie, class ... Mx>
+    struct ReverseTrieSequenceFactory : OP::flur::FactoryBase
+    {
+        using sequence_t = ReverseTrieSequence<TTrie, Mx ...>;
+        using trie_t = TTrie;
+        using trie_ptr = std::shared_ptr <const TTrie>;
+        using mixer_t = Mixer<trie_t, Mx ...>;
+
+        constexpr ReverseTrieSequenceFactory(trie_ptr trie, Mx&& ... mx) noexcept
+            :_trie(std::move(trie))
+            , _mixer(std::forward<Mx>(mx)...) 
+        {}
+        
+        constexpr auto compound() const& noexcept
+        {
+            return sequence_t(_trie, _mixer);
+        }
+        constexpr auto compound() && noexcept
+        {
+            return sequence_t(std::move(_trie), std::move(_mixer));
+        }
+    private:
+        trie_ptr _trie;
+        mixer_t _mixer;
+    };
+
     template <class TTrie, class ... Mx>
     auto make_mixed_sequence_factory(std::shared_ptr<const TTrie> trie, Mx&& ...args) noexcept
     {
@@ -467,6 +617,15 @@ namespace OP::trie
         return make_mixed_sequence_factory(std::const_pointer_cast<const TTrie>(trie), std::forward<Mx>(args)...);
     }
 
+    template <class TTrie, class ... Mx>
+    auto make_mixed_reverse_sequence_factory(std::shared_ptr<const TTrie> trie, Mx&& ...args) noexcept
+    {
+        ReverseTrieSequenceFactory<TTrie, Mx...> factory (std::move(trie), std::forward<Mx>(args)...);
+        return OP::flur::make_lazy_range(
+                std::move(factory)
+        );
+    }
+
 } //ns:OP::trie
 
 #endif //_OP_TRIE_MIXEDADAPTER__H_
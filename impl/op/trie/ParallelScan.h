@@ -0,0 +1,128 @@
+#pragma once
+
+#ifndef _OP_TRIE_PARALLELSCAN__H_
+#define _OP_TRIE_PARALLELSCAN__H_
+
+#include <deque>
+#include <future>
+#include <memory>
+#include <vector>
+#include <chrono>
+
+#include <op/flur/flur.h>
+
+namespace OP::trie
+{
+    /**
+    *   State shared between copies of ParallelScanSequence. Keeps futures of partitions that are
+    * still processed by the thread pool and results already received.
+    * \tparam Result - result of single partition processing.
+    */
+    template <class Result>
+    struct ParallelScanState
+    {
+        using future_t = std::future<Result>;
+
+        /**
+        * \param pending - futures of partitions in key order;
+        * \param keep_order - when true partitions are resolved in key order, otherwise in order of
+        *   accomplishment, so consumer doesn't wait for slow partition while others are ready.
+        */
+        ParallelScanState(std::vector<future_t> pending, bool keep_order) noexcept
+            : _pending(std::move(pending))
+            , _keep_order(keep_order)
+        {
+        }
+
+        /**
+        *   \return nth received result or nullptr if all partitions are exhausted. Result pointer
+        *   stays valid for all lifetime of this state.
+        */
+        const Result* resolve(size_t nth)
+        {
+            while (_resolved.size() <= nth)
+            {
+                if (_pending.empty())
+                    return nullptr;
+                auto ready = _pending.begin();
+                if (!_keep_order)
+                {
+                    auto found = std::find_if(_pending.begin(), _pending.end(), [](const future_t& f) {
+                        return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+                        });
+                    if (found != _pending.end())
+                        ready = found;
+                }
+                _resolved.emplace_back(ready->get());
+                _pending.erase(ready);
+            }
+            return &_resolved[nth];
+        }
+
+    private:
+        std::vector<future_t> _pending;
+        /** deque keeps references valid on append */
+        std::deque<Result> _resolved;
+        const bool _keep_order;
+    };
+
+    /**
+    *   Sequence of results of partitions processed in parallel. Depending on the state partitions are
+    *   consumed in key order or in order of accomplishment.
+    */
+    template <class Result>
+    struct ParallelScanSequence : public OP::flur::Sequence<const Result&>
+    {
+        using state_t = ParallelScanState<Result>;
+        using element_t = const Result&;
+
+        explicit ParallelScanSequence(std::shared_ptr<state_t> state) noexcept
+            : _state(std::move(state))
+        {
+        }
+
+        void start() override
+        {
+            _index = 0;
+            _current = _state->resolve(_index);
+        }
+
+        bool in_range() const override
+        {
+            return _current != nullptr;
+        }
+
+        element_t current() const override
+        {
+            return *_current;
+        }
+
+        void next() override
+        {
+            _current = _state->resolve(++_index);
+        }
+
+    private:
+        std::shared_ptr<state_t> _state;
+        size_t _index = 0;
+        const Result* _current = nullptr;
+    };
+
+    /**
+    *   Create LazyRange over results of partitions that are processed by the thread pool.
+    * \tparam keep_order_c - true to produce results in key order, false to yield them as soon as they ready.
+    * \param pending - futures of partitions in key order.
+    */
+    template <bool keep_order_c, class Result>
+    auto make_parallel_scan(std::vector<std::future<Result>> pending)
+    {
+        using state_t = ParallelScanState<Result>;
+        using sequence_t = ParallelScanSequence<Result>;
+        return OP::flur::make_lazy_range(
+            OP::flur::SimpleFactory<sequence_t, std::shared_ptr<state_t>>(
+                std::make_shared<state_t>(std::move(pending), keep_order_c)));
+    }
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_PARALLELSCAN__H_
@@ -0,0 +1,614 @@
+#pragma once
+
+#ifndef _OP_TRIE_SUCCINCTTRIE__H_
+#define _OP_TRIE_SUCCINCTTRIE__H_
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+#include <bit>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include <op/common/astr.h>
+#include <op/flur/flur.h>
+
+namespace OP::trie
+{
+    namespace succinct
+    {
+        /** Number of bits covered by single rank sample */
+        constexpr static std::uint64_t block_bits_c = 512;
+        /** Each `select_sample_c`-th zero is sampled to speed up select */
+        constexpr static std::uint64_t select_sample_c = 512;
+
+        /** Location of bit-vector inside the image, all offsets are in bytes from the image start */
+        struct BitVectorHeader
+        {
+            std::uint64_t _bits;
+            std::uint64_t _zeros;
+            std::uint64_t _words_offset;
+            std::uint64_t _rank_offset;
+            std::uint64_t _select0_offset;
+        };
+
+        /**
+        *   Readonly bit-vector with precomputed rank/select indexes. Doesn't own memory, just points
+        *   to the arrays of the image, so no work is done on load.
+        */
+        struct BitVectorView
+        {
+            const std::uint64_t* _words = nullptr;
+            /** number of ones before each block, has `blocks + 1` items */
+            const std::uint32_t* _rank = nullptr;
+            /** `_select0[j]` is a block that contains zero number `j * select_sample_c` */
+            const std::uint32_t* _select0 = nullptr;
+            std::uint64_t _bits = 0;
+            std::uint64_t _zeros = 0;
+
+            bool get(std::uint64_t i) const noexcept
+            {
+                assert(i < _bits);
+                return (_words[i / 64] >> (i % 64)) & 1;
+            }
+
+            /** \return number of ones in range `[0, i)` */
+            std::uint64_t rank1(std::uint64_t i) const noexcept
+            {
+                assert(i <= _bits);
+                const auto block = i / block_bits_c;
+                std::uint64_t result = _rank[block];
+                for (auto w = block * (block_bits_c / 64); w < i / 64; ++w)
+                    result += std::popcount(_words[w]);
+                if (i % 64)
+                    result += std::popcount(_words[i / 64] & ((std::uint64_t{ 1 } << (i % 64)) - 1));
+                return result;
+            }
+
+            /** \return position of zero number `k` (0-based) */
+            std::uint64_t select0(std::uint64_t k) const noexcept
+            {
+                assert(k < _zeros);
+                const auto blocks = (_bits + block_bits_c - 1) / block_bits_c;
+                std::uint64_t block = _select0[k / select_sample_c];
+                while (block + 1 < blocks && zeros_before(block + 1) <= k)
+                    ++block;
+                auto remaining = k - zeros_before(block);
+                for (auto w = block * (block_bits_c / 64); ; ++w)
+                {
+                    //padding after `_bits` is never reached since `k < _zeros`
+                    auto inverted = ~_words[w];
+                    const auto zeros = static_cast<std::uint64_t>(std::popcount(inverted));
+                    if (remaining < zeros)
+                    {
+                        for (; remaining; --remaining)
+                            inverted &= inverted - 1; //drop lowest zero
+                        return w * 64 + std::countr_zero(inverted);
+                    }
+                    remaining -= zeros;
+                }
+            }
+
+        private:
+            std::uint64_t zeros_before(std::uint64_t block) const noexcept
+            {
+                return block * block_bits_c - _rank[block];
+            }
+        };
+
+        /** Accumulates bits and then writes bit-vector with indexes to the image */
+        struct BitVectorBuilder
+        {
+            void push_back(bool bit)
+            {
+                if (_bits % 64 == 0)
+                    _words.push_back(0);
+                if (bit)
+                    _words.back() |= std::uint64_t{ 1 } << (_bits % 64);
+                ++_bits;
+            }
+
+            /** Append words and indexes to `image`
+            * \return header to locate bit-vector in the image
+            */
+            BitVectorHeader write(std::vector<std::uint8_t>& image) const
+            {
+                BitVectorHeader header{};
+                header._bits = _bits;
+                const auto blocks = (_bits + block_bits_c - 1) / block_bits_c;
+                std::vector<std::uint32_t> rank;
+                std::vector<std::uint32_t> select0;
+                std::uint64_t ones = 0;
+                for (std::uint64_t i = 0; i < _bits; ++i)
+                {
+                    if (i % block_bits_c == 0)
+                        rank.push_back(static_cast<std::uint32_t>(ones));
+                    if ((_words[i / 64] >> (i % 64)) & 1)
+                        ++ones;
+                    else if (header._zeros++ % select_sample_c == 0)
+                        select0.push_back(static_cast<std::uint32_t>(i / block_bits_c));
+                }
+                rank.push_back(static_cast<std::uint32_t>(ones));
+                assert(rank.size() == blocks + 1);
+                header._words_offset = append(image, _words.data(), _words.size());
+                header._rank_offset = append(image, rank.data(), rank.size());
+                header._select0_offset = append(image, select0.data(), select0.size());
+                return header;
+            }
+
+            /** Append array to the image, keeping 8 bytes alignment
+            * \return offset of the first byte
+            */
+            template <class T>
+            static std::uint64_t append(std::vector<std::uint8_t>& image, const T* data, size_t count)
+            {
+                const auto offset = image.size();
+                image.resize(offset + ((sizeof(T) * count + 7) & ~size_t{ 7 }), 0);
+                if (count)
+                    std::memcpy(image.data() + offset, data, sizeof(T) * count);
+                return offset;
+            }
+
+        private:
+            std::vector<std::uint64_t> _words;
+            std::uint64_t _bits = 0;
+        };
+
+        /** Starting block of the image */
+        struct ImageHeader
+        {
+            constexpr static std::uint64_t magic_c = 0x31544343'5553504Full; //"OPSUCCT1"
+
+            std::uint64_t _magic;
+            std::uint64_t _value_size;
+            std::uint64_t _nodes;
+            std::uint64_t _terminals;
+            BitVectorHeader _louds;
+            BitVectorHeader _terminal;
+            std::uint64_t _labels_offset;
+            std::uint64_t _values_offset;
+            std::uint64_t _image_size;
+        };
+    }//ns:succinct
+
+    /**
+    *   Immutable compact image of the Trie. Trie is encoded as LOUDS (level-order unary degree sequence):
+    *   nodes are numbered in breadth-first order, each node is written as `1` per child followed by `0`, so
+    *   node is just an ordinal and children are located by `select0` without any pointers. Each edge keeps
+    *   a single atom (label), labels of all edges are packed into byte array in the same order. Bit-vector
+    *   of terminal flags, together with `rank1`, maps node to the index in the packed array of values.
+    *
+    *   Image is a single contiguous memory block with the native byte order that contains all the
+    *   rank/select indexes, so it can be mapped directly from the file and used without any preparation.
+    *   Use #export_from to create image and #open to access it.
+    *
+    *   \tparam TValue - type of value, must be trivially copyable.
+    */
+    template <class TValue>
+    class SuccinctTrie : public std::enable_shared_from_this<SuccinctTrie<TValue>>
+    {
+        static_assert(std::is_trivially_copyable_v<TValue>, "only trivially copyable values can be packed");
+    public:
+        using this_t = SuccinctTrie<TValue>;
+        using value_type = TValue;
+        using atom_t = OP::common::atom_t;
+        using key_t = OP::common::atom_string_t;
+        using node_t = std::uint64_t;
+
+        /** Position of terminal node, the key is restored while navigating from the root */
+        class iterator
+        {
+            friend this_t;
+            const this_t* _owner = nullptr;
+            /** nodes from the root to the current, empty for end */
+            std::vector<node_t> _path;
+            key_t _key;
+
+            explicit iterator(const this_t* owner) noexcept
+                : _owner(owner)
+            {
+            }
+
+        public:
+            iterator() = default;
+
+            const key_t& key() const noexcept
+            {
+                return _key;
+            }
+
+            value_type value() const
+            {
+                assert(!is_end());
+                return _owner->value_of(_path.back());
+            }
+
+            value_type operator*() const
+            {
+                return value();
+            }
+
+            bool is_end() const noexcept
+            {
+                return _path.empty();
+            }
+
+            bool operator == (const iterator& other) const noexcept
+            {
+                return _path == other._path;
+            }
+        };
+
+        /**
+        *   Build image from the existing trie.
+        *   \tparam Trie - any trie that supports `begin/in_range/next` and iterator with `key()`/`value()`
+        *       (for example OP::trie::Trie), value must be convertible to #value_type.
+        *   \return image that can be stored to file as is and accessed by #open
+        */
+        template <class Trie>
+        static std::vector<std::uint8_t> export_from(const Trie& trie)
+        {
+            using namespace succinct;
+            std::vector<std::pair<key_t, value_type>> items;
+            for (auto i = trie.begin(); trie.in_range(i); trie.next(i))
+                items.emplace_back(key_t(i.key().begin(), i.key().end()), i.value());
+
+            BitVectorBuilder louds, terminal;
+            std::vector<atom_t> labels;
+            std::vector<value_type> values;
+            //each level is a list of item ranges that share prefix of `depth` length (so a node)
+            struct Range
+            {
+                size_t _begin, _end;
+            };
+            std::vector<Range> level{ Range{0, items.size()} }, next_level;
+            std::uint64_t nodes = 0;
+            for (size_t depth = 0; !level.empty(); ++depth)
+            {
+                next_level.clear();
+                for (auto [lo, hi] : level)
+                {
+                    ++nodes;
+                    //items are sorted, so exact match is always the first in the range
+                    const bool is_terminal = lo < hi && items[lo].first.size() == depth;
+                    terminal.push_back(is_terminal);
+                    if (is_terminal)
+                        values.push_back(items[lo++].second);
+                    while (lo < hi)
+                    {
+                        const atom_t label = items[lo].first[depth];
+                        auto child_end = lo;
+                        while (child_end < hi && items[child_end].first[depth] == label)
+                            ++child_end;
+                        louds.push_back(true);
+                        labels.push_back(label);
+                        next_level.push_back(Range{ lo, child_end });
+                        lo = child_end;
+                    }
+                    louds.push_back(false);
+                }
+                std::swap(level, next_level);
+            }
+
+            std::vector<std::uint8_t> image;
+            ImageHeader header{};
+            BitVectorBuilder::append(image, &header, 1); //placeholder
+            header._magic = ImageHeader::magic_c;
+            header._value_size = sizeof(value_type);
+            header._nodes = nodes;
+            header._terminals = values.size();
+            header._louds = louds.write(image);
+            header._terminal = terminal.write(image);
+            header._labels_offset = BitVectorBuilder::append(image, labels.data(), labels.size());
+            header._values_offset = BitVectorBuilder::append(image, values.data(), values.size());
+            header._image_size = image.size();
+            std::memcpy(image.data(), &header, sizeof(header));
+            return image;
+        }
+
+        /**
+        *   Access image without copy. Memory must stay valid for all lifetime of result (for
+        *   example memory mapped file).
+        *   \param data - start of image, must be aligned on 8 bytes.
+        *   \throws std::invalid_argument if image is malformed or created for another value type
+        */
+        static std::shared_ptr<this_t> open(const void* data, size_t size)
+        {
+            return std::shared_ptr<this_t>(new this_t(data, size));
+        }
+
+        /** Open image that is owned by the result
+        *   \throws std::invalid_argument if image is malformed or created for another value type
+        */
+        static std::shared_ptr<this_t> open(std::vector<std::uint8_t> image)
+        {
+            auto result = std::shared_ptr<this_t>(new this_t(image.data(), image.size()));
+            result->_own = std::move(image); //move keeps the buffer
+            return result;
+        }
+
+        /** Total number of items */
+        std::uint64_t size() const noexcept
+        {
+            return _header->_terminals;
+        }
+
+        /** Number of nodes, each node corresponds to a single atom of the key */
+        std::uint64_t nodes_count() const noexcept
+        {
+            return _header->_nodes;
+        }
+
+        /** Size of the image in bytes */
+        std::uint64_t image_size() const noexcept
+        {
+            return _header->_image_size;
+        }
+
+        iterator begin() const
+        {
+            iterator result(this);
+            if (!size())
+                return result;
+            result._path.push_back(0);
+            enter_leftmost(result);
+            return result;
+        }
+
+        iterator end() const
+        {
+            return iterator(this);
+        }
+
+        bool in_range(const iterator& check) const noexcept
+        {
+            return !check.is_end();
+        }
+
+        /** Move iterator to the next key in lexicographic order */
+        void next(iterator& i) const
+        {
+            if (i.is_end())
+                return;
+            auto [first, last] = children(i._path.back());
+            if (first < last)
+            {
+                push(i, first);
+                enter_leftmost(i);
+            }
+            else
+                skip_subtree(i);
+        }
+
+        /** \return iterator to the exact matching key or #end() */
+        template <class AtomString>
+        iterator find(const AtomString& container) const
+        {
+            iterator result(this);
+            if (!size())
+                return result;
+            result._path.push_back(0);
+            for (auto atom : container)
+            {
+                auto [first, last] = children(result._path.back());
+                auto found = std::lower_bound(_labels + first, _labels + last, static_cast<atom_t>(atom));
+                if (found == _labels + last || *found != static_cast<atom_t>(atom))
+                    return end();
+                push(result, found - _labels);
+            }
+            return _terminal.get(result._path.back()) ? result : end();
+        }
+
+        template <class AtomString>
+        bool check_exists(const AtomString& container) const
+        {
+            return !find(container).is_end();
+        }
+
+        /** \return iterator to the smallest key that is not less than `container` */
+        template <class AtomString>
+        iterator lower_bound(const AtomString& container) const
+        {
+            iterator result(this);
+            if (!size())
+                return result;
+            result._path.push_back(0);
+            for (auto atom : container)
+            {
+                auto [first, last] = children(result._path.back());
+                auto found = std::lower_bound(_labels + first, _labels + last, static_cast<atom_t>(atom));
+                if (found == _labels + last)
+                { //all keys with current prefix are less
+                    skip_subtree(result);
+                    return result;
+                }
+                push(result, found - _labels);
+                if (*found != static_cast<atom_t>(atom))
+                    break; //all keys in subtree are greater
+            }
+            enter_leftmost(result);
+            return result;
+        }
+
+        /** \return OP::flur lazy range of all keys in lexicographic order */
+        auto range() const
+        {
+            return prefixed_range(key_t{});
+        }
+
+        /** \return OP::flur lazy range of all keys that start with `prefix` in lexicographic order */
+        template <class AtomString>
+        auto prefixed_range(const AtomString& prefix) const
+        {
+            return OP::flur::make_lazy_range(
+                OP::flur::SimpleFactory<Sequence, std::shared_ptr<const this_t>, key_t>(
+                    this->shared_from_this(), key_t(std::begin(prefix), std::end(prefix))));
+        }
+
+    private:
+        /** Sequence of keys that start with specific prefix */
+        struct Sequence : public OP::flur::OrderedSequence<const iterator&>
+        {
+            Sequence(std::shared_ptr<const this_t> owner, key_t prefix) noexcept
+                : _owner(std::move(owner))
+                , _prefix(std::move(prefix))
+            {
+            }
+
+            void start() override
+            {
+                _current = _owner->lower_bound(_prefix);
+            }
+
+            bool in_range() const override
+            {
+                return !_current.is_end()
+                    && _current.key().compare(0, _prefix.size(), _prefix) == 0;
+            }
+
+            const iterator& current() const override
+            {
+                return _current;
+            }
+
+            void next() override
+            {
+                _owner->next(_current);
+            }
+
+        private:
+            std::shared_ptr<const this_t> _owner;
+            key_t _prefix;
+            iterator _current;
+        };
+
+        SuccinctTrie(const void* data, size_t size)
+        {
+            using namespace succinct;
+            auto bytes = static_cast<const std::uint8_t*>(data);
+            if (reinterpret_cast<std::uintptr_t>(data) % alignof(std::uint64_t))
+                throw std::invalid_argument("succinct image must be aligned on 8 bytes");
+            if (size < sizeof(ImageHeader))
+                throw std::invalid_argument("succinct image is too small");
+            _header = reinterpret_cast<const ImageHeader*>(bytes);
+            if (_header->_magic != ImageHeader::magic_c)
+                throw std::invalid_argument("not a succinct trie image");
+            if (_header->_value_size != sizeof(value_type))
+                throw std::invalid_argument("succinct image is created for another value type");
+            if (_header->_image_size > size)
+                throw std::invalid_argument("succinct image is truncated");
+            //each node has single `0` in LOUDS and each edge (all nodes except root) has single `1`
+            const auto& h = *_header;
+            if (h._nodes == 0 || h._nodes > h._image_size
+                || h._louds._bits != 2 * h._nodes - 1 || h._louds._zeros != h._nodes
+                || h._terminal._bits != h._nodes || h._terminal._zeros > h._nodes
+                || h._terminals != h._nodes - h._terminal._zeros)
+                throw std::invalid_argument("succinct image has inconsistent counters");
+            check_bit_vector(h, h._louds);
+            check_bit_vector(h, h._terminal);
+            check_array<atom_t>(h, h._labels_offset, h._nodes - 1);
+            check_array<value_type>(h, h._values_offset, h._terminals);
+            _louds = view(bytes, _header->_louds);
+            _terminal = view(bytes, _header->_terminal);
+            _labels = reinterpret_cast<const atom_t*>(bytes + _header->_labels_offset);
+            _values = bytes + _header->_values_offset;
+        }
+
+        /** Throw if array of `count` items of `T` at `offset` doesn't lay inside the image or is misaligned */
+        template <class T>
+        static void check_array(const succinct::ImageHeader& header, std::uint64_t offset, std::uint64_t count)
+        {
+            //export_from aligns every array on 8 bytes
+            if (offset < sizeof(succinct::ImageHeader) || offset > header._image_size || offset % alignof(T)
+                || count > (header._image_size - offset) / sizeof(T))
+                throw std::invalid_argument("succinct image array is out of bounds");
+        }
+
+        static void check_bit_vector(const succinct::ImageHeader& header, const succinct::BitVectorHeader& vector)
+        {
+            using namespace succinct;
+            const auto blocks = (vector._bits + block_bits_c - 1) / block_bits_c;
+            check_array<std::uint64_t>(header, vector._words_offset, (vector._bits + 63) / 64);
+            check_array<std::uint32_t>(header, vector._rank_offset, blocks + 1);
+            check_array<std::uint32_t>(header, vector._select0_offset, (vector._zeros + select_sample_c - 1) / select_sample_c);
+        }
+
+        static succinct::BitVectorView view(const std::uint8_t* bytes, const succinct::BitVectorHeader& header) noexcept
+        {
+            succinct::BitVectorView result;
+            result._words = reinterpret_cast<const std::uint64_t*>(bytes + header._words_offset);
+            result._rank = reinterpret_cast<const std::uint32_t*>(bytes + header._rank_offset);
+            result._select0 = reinterpret_cast<const std::uint32_t*>(bytes + header._select0_offset);
+            result._bits = header._bits;
+            result._zeros = header._zeros;
+            return result;
+        }
+
+        /** \return range of edges `[first, last)` that lead to children of `node`, edge `e` leads to node `e + 1` */
+        std::pair<std::uint64_t, std::uint64_t> children(node_t node) const noexcept
+        {
+            const auto start = node ? _louds.select0(node - 1) + 1 : 0;
+            const auto stop = _louds.select0(node);
+            //there are exactly `node` zeros before `start`
+            return { start - node, stop - node };
+        }
+
+        value_type value_of(node_t node) const noexcept
+        {
+            value_type result;
+            //image may be mapped without alignment of values
+            std::memcpy(&result, _values + sizeof(value_type) * _terminal.rank1(node), sizeof(value_type));
+            return result;
+        }
+
+        void push(iterator& i, std::uint64_t edge) const
+        {
+            i._path.push_back(edge + 1);
+            i._key.push_back(_labels[edge]);
+        }
+
+        /** Go down by the first children until terminal node */
+        void enter_leftmost(iterator& i) const
+        {
+            while (!_terminal.get(i._path.back()))
+            {
+                auto [first, last] = children(i._path.back());
+                assert(first < last); //each leaf is terminal
+                push(i, first);
+            }
+        }
+
+        /** Move to the first terminal after all keys of the current node subtree */
+        void skip_subtree(iterator& i) const
+        {
+            while (i._path.size() > 1)
+            {
+                const auto edge = i._path.back() - 1;
+                i._path.pop_back();
+                i._key.pop_back();
+                auto [first, last] = children(i._path.back());
+                if (edge + 1 < last)
+                {
+                    push(i, edge + 1);
+                    enter_leftmost(i);
+                    return;
+                }
+            }
+            i._path.clear();
+            i._key.clear();
+        }
+
+        std::vector<std::uint8_t> _own;
+        const succinct::ImageHeader* _header = nullptr;
+        succinct::BitVectorView _louds;
+        succinct::BitVectorView _terminal;
+        const atom_t* _labels = nullptr;
+        const std::uint8_t* _values = nullptr;
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_SUCCINCTTRIE__H_
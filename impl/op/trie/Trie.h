@@ -11,6 +11,14 @@
 #include <memory>
 #include <future>
 #include <stack>
+#include <optional>
+#include <algorithm>
+#include <concepts>
+#include <map>
+#include <unordered_map>
+#include <tuple>
+#include <thread>
+#include <shared_mutex>
 
 #include <op/common/astr.h>
 #include <op/trie/Containers.h>
@@ -23,8 +31,17 @@
 #include <op/trie/TrieNode.h>
 #include <op/trie/TrieIterator.h>
 #include <op/trie/TrieResidence.h>
+#include <op/trie/MembershipFilter.h>
 #include <op/trie/StoreConverter.h>
 #include <op/trie/MixedAdapter.h>
+#include <op/trie/TrieSnapshot.h>
+#include <op/trie/ParallelScan.h>
+#include <op/trie/FuzzyMatch.h>
+#include <op/trie/GlobMatch.h>
+#include <op/trie/ChangeFeed.h>
+#include <op/trie/ExpiringValueManager.h>
+#include <op/trie/BlobValueManager.h>
+#include <op/trie/CompressedValueManager.h>
 
 #include <op/vtm/StringMemoryManager.h>
 
@@ -40,44 +57,107 @@ namespace OP
             *   How many key entries allocate on particular node depending on trie level. Quick
             * navigation on trie granted by algorithms of lookup particular byte on node level. Root
             * level (0) always use 256 items to lookup, but for lower levels it can be wasting of the
-            * disk and memory space. Lower levels use hash algorithms to locate key entry, these algorithms
-            * works on 8, 32, 64 and 128 table sizes. Overriding this option you can improve heuristic behavior.
+            * disk and memory space. Lower levels start from compact dense layout that keeps entries sorted
+            * by key (4, 16 and 48 entries) and grow up to 256 table on demand
+            * (\sa containers::details::node_grow_size). Overriding this option you can improve heuristic behavior.
             */
             vtm::dim_t init_node_size(size_t level) const
             {
                 return level == 0 ? 256 : _node_size;
             }
         private:
-            vtm::dim_t _node_size = 8;
+            vtm::dim_t _node_size = containers::details::dense_capacity(4);
         };
 
+        /** Ready to use resolvers of value conflicts for Trie::merge_from */
+        namespace merge_policy
+        {
+            /** Key existing in both tries keeps value of the target trie */
+            struct keep_target
+            {
+                template <class T>
+                const T& operator()(const T& target, const T& /*source*/) const noexcept
+                {
+                    return target;
+                }
+            };
+
+            /** Key existing in both tries takes value of the merged (source) trie */
+            struct take_source
+            {
+                template <class T>
+                const T& operator()(const T& /*target*/, const T& source) const noexcept
+                {
+                    return source;
+                }
+            };
+        }//ns:merge_policy
+
+        namespace details
+        {
+            /** Payload manager may ask for additional slots of topology by `using topology_slots_t = std::tuple<TSlot...>` */
+            template <class TPayloadManager>
+            struct payload_slots
+            {
+                using type = std::tuple<>;
+            };
+
+            template <class TPayloadManager>
+                requires requires { typename TPayloadManager::topology_slots_t; }
+            struct payload_slots<TPayloadManager>
+            {
+                using type = typename TPayloadManager::topology_slots_t;
+            };
+
+            /** Topology of `TSlot...` followed by payload slots and HeapManagerSlot that must go last */
+            template <class TPayloadSlots, class ... TSlot>
+            struct trie_topology;
+
+            template <class ... TPayloadSlot, class ... TSlot>
+            struct trie_topology<std::tuple<TPayloadSlot...>, TSlot...>
+            {
+                using type = vtm::SegmentTopology<TSlot..., TPayloadSlot..., vtm::HeapManagerSlot>;
+            };
+        }//ns:details
+
 
         template <
             class TSegmentManager, 
             class TPayloadManager, 
             class TKeyString,
-            std::uint32_t initial_node_count = 512
+            std::uint32_t initial_node_count = 512,
+            TrieFeature features = TrieFeature::none
         >
         struct Trie : public std::enable_shared_from_this< 
-            Trie<TSegmentManager, TPayloadManager, TKeyString, initial_node_count> >
+            Trie<TSegmentManager, TPayloadManager, TKeyString, initial_node_count, features> >
         {
         public:
             using atom_t = OP::common::atom_t;
             using dim_t = OP::vtm::dim_t;
             using FarAddress = OP::vtm::FarAddress;
             using NullableAtom = vtm::NullableAtom;
-            using trie_t = Trie<TSegmentManager, TPayloadManager, TKeyString, initial_node_count>;
+            using trie_t = Trie<TSegmentManager, TPayloadManager, TKeyString, initial_node_count, features>;
             using payload_manager_t = TPayloadManager;
             using payload_t = typename payload_manager_t::payload_t;
             using this_t = trie_t;
             using iterator = TrieIterator<this_t>;
             using value_type = typename payload_manager_t::source_payload_t;
-            using node_t = TrieNode<payload_manager_t>;
+            /** true if nodes keep subtree counters (\sa TrieFeature::subtree_counters) */
+            constexpr static bool subtree_counters_c = has_feature(features, TrieFeature::subtree_counters);
+            using node_t = TrieNode<payload_manager_t, subtree_counters_c>;
+            /** true if keys are added to MembershipFilter (\sa TrieFeature::membership_filter) */
+            constexpr static bool membership_filter_c = has_feature(features, TrieFeature::membership_filter);
             using position_t = TriePosition;
             using key_t = TKeyString;
             using key_view_t = std::basic_string_view<typename key_t::value_type>;
             using insert_result_t = std::pair<iterator, bool>;
             using storage_converter_t = typename payload_manager_t::storage_converter_t;
+            using snapshot_t = TrieSnapshot<key_t, value_type>;
+            using change_record_t = ChangeRecord<key_t, value_type>;
+            using change_reader_t = ChangeFeedReader<key_t, value_type>;
+
+            /** Default number of keys #compact_to and #minimize_to copy in the scope of single transaction */
+            constexpr static size_t compaction_chunk_c = 4096;
 
             virtual ~Trie()
             {
@@ -97,20 +177,32 @@ namespace OP
                 new_trie->_topology->template slot<TrieResidence> ()
                     .update([root_addr = new_trie->_root](auto& header){
                         header._root = root_addr;
+                        header._features = static_cast<std::uint32_t>(features);
                     });
+                new_trie->refill_filter(0);
 
                 op_g.commit();
                 return new_trie;
             }
             
+            /**
+            *   Open trie previously created by #create_new.
+            * \throws OP::Exception with code vtm::ErrorCodes::er_invalid_signature if storage has been created
+            *   with another layout of trie or with another set of TrieFeature.
+            */
             static std::shared_ptr<Trie> open(std::shared_ptr<TSegmentManager>& segment_manager)
             {
                 auto existing_trie = std::shared_ptr<this_t>(new this_t(segment_manager));
                 auto header =
                     existing_trie->_topology->template slot<TrieResidence> ()
                     .get_header();
+                if (header._format != TrieResidence::format_c)
+                    throw OP::Exception(vtm::ErrorCodes::er_invalid_signature, "storage has incompatible layout of trie");
+                if (header._features != static_cast<std::uint32_t>(features))
+                    throw OP::Exception(vtm::ErrorCodes::er_invalid_signature, "storage has been created with another set of trie features");
                 existing_trie->_version = header._version;
                 existing_trie->_root = header._root;
+                existing_trie->_minimized = header._minimized != 0;
                 return existing_trie;
             }
 
@@ -142,6 +234,51 @@ namespace OP
                 return h._nodes_allocated;
             }
 
+            /**
+            *   \return true if trie was built with suffix sharing (\sa #bulk_load, #minimize_to) and is read-only.
+            *   Such trie can be made writable only by copying it with #compact_to.
+            */
+            bool is_minimized() const noexcept
+            {
+                return _minimized;
+            }
+
+            /** Number of keys that are still present in MembershipFilter after erase. Each of them
+            *   increases rate of false positives, so caller may decide to #rebuild_filter when the
+            *   number becomes comparable with #size.
+            */
+            std::uint64_t filter_stale_count() const
+                requires (membership_filter_c)
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                auto header = _topology->template slot<TrieResidence>().get_header();
+                return header._filter_added > header._count ? header._filter_added - header._count : 0;
+            }
+
+            /** Number of keys MembershipFilter may hold with false positive rate below ~1%. Filter is
+            *   re-populated with doubled capacity automatically when number of added keys exceeds it, until
+            *   the filter reaches the max size allowed by the segment (\sa MembershipFilter::max_block_count).
+            */
+            std::uint64_t filter_capacity() const
+                requires (membership_filter_c)
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                return _topology->template slot<MembershipFilter>().capacity();
+            }
+
+            /** Re-populate MembershipFilter from the actual keys to forget erased ones. Filter is resized
+            *   to fit current number of keys.
+            *   Everything is done in the single transaction, trie version is not changed.
+            */
+            void rebuild_filter()
+                requires (membership_filter_c)
+            {
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction());
+                refill_filter(size());
+                op_g.commit();
+            }
+
             iterator begin() const
             {
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
@@ -165,6 +302,36 @@ namespace OP
             {
                 return iterator(this, typename iterator::end_marker_t{});
             }
+
+            /** \return iterator to the lexicographically biggest entry or `end()` if trie is empty */
+            iterator last() const
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                auto next_addr = _root;
+                iterator i(this);
+                bool ok = true;
+                auto locator = [](vtm::ReadonlyAccess<node_t>& ro_node) { return ro_node->last(); };
+                do{
+                    std::tie(ok, next_addr) = load_iterator(
+                        next_addr, i, locator, &iterator::emplace);
+                    if (!ok)
+                    {
+                        assert(i.node_count() == 0);//allowed !ok only for zero level
+                        return end();
+                    }
+                } while (all_set(i.rat().terminality(), Terminality::term_has_child));
+                return i;
+            }
+
+            /** Start point of descending iteration, just alias of #last. For example: \code
+            *   for(auto i = trie.rbegin(); trie.in_range(i); trie.prev(i))
+            *       ...
+            *   \endcode
+            */
+            iterator rbegin() const
+            {
+                return last();
+            }
             /** check if iterator is not end() */
             bool in_range(const iterator& check) const
             {
@@ -179,6 +346,23 @@ namespace OP
                     _next(i);
                 }
             }
+
+            /** Shift iterator to the previous (lexicographically smaller) position. If `i` is `end()`
+            *   then it is moved to #last, when `i` points to the smallest entry it becomes `end()`.
+            */
+            void prev(iterator& i) const
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true); //place all RO operations to atomic scope
+                if (i.is_end())
+                {
+                    i = last();
+                    return;
+                }
+                if (sync_iterator(i))
+                {
+                    _prev(i);
+                }
+            }
             /**
             * Iterate next item that is not prefixed by current (`i`). In other words select right of this or parent. In compare with
             * regular `next` doesn't enter to child way of current iterator (`i`).
@@ -251,7 +435,9 @@ namespace OP
                 {
                     while (mis_it < i.key().end())
                         i.pop();
-                    lower_bound_impl(mis_key, key.end(), i);
+                    //pop may cut stem before the mismatch, so continue right after remaining prefix
+                    auto rest = key.begin() + i.key().size();
+                    lower_bound_impl(rest, key.end(), i);
                 }
             }
 
@@ -291,6 +477,46 @@ namespace OP
                 return i_beg;
             }
 
+            /** return last (lexicographically biggest) entry that contains prefix specified by string [begin, aend)
+            *   @param begin - first symbol of string to lookup
+            *   @param aend - end of string to lookup
+            *   \tparam IterateAtom iterator of string
+            */
+            template <class IterateAtom>
+            iterator prefixed_last(IterateAtom begin, IterateAtom aend) const
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true); //place all RO operations to atomic scope
+                iterator i(this);
+                auto nav = common_prefix(begin, aend, i);
+                if (begin != aend) //no such prefix since begin wasn't exhausted
+                    return end();
+                FarAddress child;
+                if (nav == StemCompareResult::string_end) //key partially matches to some prefix
+                { //correct string at the back of iterator
+                    bool ok;
+                    const auto key = i.rat().key();
+                    std::tie(ok, child) = load_iterator(i.rat().address(), i,
+                        [key](vtm::ReadonlyAccess<node_t>&) {
+                            return NullableAtom{ key };
+                        },
+                        &iterator::update_back);
+                    assert(ok);//tail must exists
+                }
+                else if (nav == StemCompareResult::equals)
+                {
+                    if (is_not_set(i.rat().terminality(), Terminality::term_has_child))
+                        return i; //exact match without children
+                    const auto& back = i.rat();
+                    child = vtm::view<node_t>(*_topology, back.address())
+                        ->get_child(*_topology, static_cast<atom_t>(back.key()));
+                }
+                else
+                    return end();
+                if (all_set(i.rat().terminality(), Terminality::term_has_child))
+                    enter_deep_until_last(child, i);
+                return i;
+            }
+
             /**
             @return an iterator pointing to the first element that is not less than (i.e. greater or equal to) key
                 specified as [begin, aend).
@@ -376,6 +602,8 @@ namespace OP
             iterator find(Atom& begin, Atom aend) const
             {
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                if (filter_rejects(begin, aend))
+                    return end(); //definitely absent
                 iterator it(this);
                 if (lower_bound_impl(begin, aend, it))
                 {
@@ -433,12 +661,15 @@ namespace OP
             *   Quick check if some string exists in this trie.
             *   @param containser - string to check. Type must support `std::begin` / `std::end` functions
             *   @return true if exists exact string matching. Note, if trie contains only `abc`, and you check `ab`
-            *   method returns fals since it is not exact matching
+            *   method returns fals since it is not exact matching. When trie has TrieFeature::membership_filter
+            *   most of absent strings are rejected without navigation over the trie.
             */
             template <class AtomString>
             bool check_exists(const AtomString& container) const
             {
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                if (filter_rejects(std::begin(container), std::end(container)))
+                    return false;
                 auto b = std::begin(container);
                 iterator iter = end();
 
@@ -459,6 +690,39 @@ namespace OP
                 return nav_res == StemCompareResult::equals || nav_res == StemCompareResult::string_end;
             }
 
+            /**
+            *   Batched form of #find. All keys are resolved in a single transaction scope and
+            *   navigation path of previous key is reused for the common prefix with next one, so
+            *   only differing suffix is navigated.
+            *   \param keys - range of keys, each key must support `std::begin` / `std::end` functions.
+            *       Any order is allowed, but sorted keys give the best reuse of the common prefix.
+            *   \param out - output iterator that receives exactly one `iterator` per key. For absent
+            *       key `end()` is written.
+            *   \return `out` advanced past the last written item
+            */
+            template <class KeyRange, class OutputIterator>
+            OutputIterator find_many(const KeyRange& keys, OutputIterator out) const
+            {
+                lookup_many(keys, [&](StemCompareResult found, const iterator& pos) {
+                    *out++ = (found == StemCompareResult::equals) ? pos : end();
+                    });
+                return out;
+            }
+
+            /**
+            *   Batched form of #check_exists. See #find_many for details.
+            *   \param out - output iterator that receives exactly one `bool` per key.
+            *   \return `out` advanced past the last written item
+            */
+            template <class KeyRange, class OutputIterator>
+            OutputIterator check_exists_many(const KeyRange& keys, OutputIterator out) const
+            {
+                lookup_many(keys, [&](StemCompareResult found, const iterator&) {
+                    *out++ = (found == StemCompareResult::equals);
+                    });
+                return out;
+            }
+
             /** \return check if iterator points to the prefix that has some child.
             *   Method is always false for `end()` or invalid iterators.
             */
@@ -547,6 +811,367 @@ namespace OP
                     );
             }
 
+            /**
+            *   Construct a range that contains all strings started with specified prefix in descending
+            *   order. Since all flur ordered algorithms (joins, merges) assume ascending order, result is
+            *   plain (not ordered) sequence.
+            * @param prefix is any string of bytes that supports std::begin / std::end iteration
+            */
+            template <class AtomContainer>
+            auto reverse_prefixed_range(const AtomContainer& prefix) const
+            {
+                return
+                    make_mixed_reverse_sequence_factory(
+                        std::const_pointer_cast<const this_t>(this->shared_from_this()),
+                        Ingredient::PrefixedLast(prefix),
+                        Ingredient::PrevNext{},
+                        Ingredient::PrefixedInRange(StartWithPredicate(prefix))
+                    );
+            }
+
+            /**
+            *   Construct a range of all keys within `max_edits` Levenshtein distance (single atom insertion,
+            *   deletion or substitution) from the `query`. Instead of filtering entire trie the range is
+            *   driven by Levenshtein automaton that skips whole subtree as soon as its prefix cannot be
+            *   completed to acceptable key, so cost is proportional to the neighbourhood of the query rather
+            *   than to the size of the trie.
+            * @param query is any string of bytes that supports std::begin / std::end iteration
+            * @return OP::flur lazy range that produces ordered TrieSequence (sequence of Trie::iterator)
+            */
+            template <class AtomContainer>
+            auto fuzzy_range(const AtomContainer& query, size_t max_edits) const
+            {
+                return
+                    make_mixed_sequence_factory(
+                        std::const_pointer_cast<const this_t>(this->shared_from_this()),
+                        Ingredient::FuzzyMatch<key_t>(key_t(std::begin(query), std::end(query)), max_edits)
+                    );
+            }
+
+            /**
+            *   Construct a range of all keys that match glob `pattern` (\sa GlobAutomaton for syntax), for
+            *   example `user:*:session:2026-??`. Pattern is compiled to DFA that is walked together with the
+            *   trie: as soon as some atom of the key is rejected iteration seeks to the nearest atom allowed
+            *   by automaton, so non-matching subtrees are never visited.
+            * @param pattern is any string of bytes that supports std::begin / std::end iteration
+            * @return OP::flur lazy range that produces ordered TrieSequence (sequence of Trie::iterator)
+            * @throws std::invalid_argument if pattern is malformed
+            */
+            template <class AtomContainer>
+            auto match_range(const AtomContainer& pattern) const
+            {
+                return
+                    make_mixed_sequence_factory(
+                        std::const_pointer_cast<const this_t>(this->shared_from_this()),
+                        Ingredient::GlobMatch(GlobAutomaton(pattern))
+                    );
+            }
+
+            /**
+            *   Create immutable view of entire trie pinned to the current version (\sa TrieSnapshot).
+            *   Content is copied under single read transaction while modifying operations of this trie wait,
+            *   so result always reflects exactly one version. Snapshot taken from the thread that is inside
+            *   of modifying operation (e.g. from merge conflict resolver) doesn't block other writers.
+            *   Note! Snapshot is a copy, not a copy-on-write view: time and memory are proportional to number
+            *   of copied entries and writers are delayed for the same time. Prefer #snapshot(const AtomContainer&)
+            *   to bound the cost.
+            */
+            snapshot_t snapshot() const
+            {
+                return make_snapshot(
+                    [this]() { return begin(); },
+                    [](const iterator&) { return true; });
+            }
+
+            /**
+            *   Same as #snapshot() but copies only entries that start with `prefix`.
+            * @param prefix is any string of bytes that supports std::begin / std::end iteration
+            */
+            template <class AtomContainer>
+            snapshot_t snapshot(const AtomContainer& prefix) const
+            {
+                return make_snapshot(
+                    [&]() { return prefixed_begin(std::begin(prefix), std::end(prefix)); },
+                    StartWithPredicate(prefix));
+            }
+
+            /**
+            *   Attach change-data-capture feed. After that each successful #insert, #update, #upsert, #erase,
+            *   #prefixed_erase_all, #erase_range, #append_value and Batch::apply emits compact record to the
+            *   `feed`, tagged with the version of the trie after the operation. Records are written at commit of
+            *   the outermost transaction in order of commit, so when the trie operation is the part of outer user
+            *   transaction records appear only after the user commits and rollback drops them. Bulk construction
+            *   (#bulk_load) and #merge_from are not captured, so replica must be seeded after them. Use
+            *   ChangeFeedReader (\sa change_reader_t) to consume the feed and apply it to the replica trie.
+            *   Operation which record is bigger than segment of the feed log is rolled back and raises
+            *   std::length_error (\sa ChangeFeed::fits).
+            *
+            *   Method isn't synchronized with concurrent modifications, attach the feed before sharing the trie.
+            * \param feed - feed to write, `nullptr` detaches current feed.
+            */
+            void change_feed(std::shared_ptr<ChangeFeed> feed)
+            {
+                static_assert(ChangeCodec<value_type>::supported_c,
+                    "change feed needs OP::trie::ChangeCodec specialization for the value type");
+                _change_feed = std::move(feed);
+            }
+
+            const std::shared_ptr<ChangeFeed>& change_feed() const noexcept
+            {
+                return _change_feed;
+            }
+
+            /**
+            *   Count keys that start with `prefix`. In compare with iteration over #prefixed_range this
+            *   method uses subtree counters of nodes, so complexity is O(prefix length). Available only for trie
+            *   with TrieFeature::subtree_counters.
+            * @param prefix is any string of bytes that supports std::begin / std::end iteration, empty
+            *   prefix matches to entire trie
+            */
+            template <class AtomContainer>
+            std::uint64_t count_prefix(const AtomContainer& prefix) const
+                requires (subtree_counters_c)
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                auto begin = std::begin(prefix);
+                auto aend = std::end(prefix);
+                if (begin == aend)
+                    return vtm::view<node_t>(*_topology, _root)->subtree_count();
+                iterator i(this);
+                auto nav = common_prefix(begin, aend, i);
+                if (begin != aend || !OP::utils::any_of<StemCompareResult::equals, StemCompareResult::string_end>(nav))
+                    return 0;
+                const auto& back = i.rat();
+                return entry_weight(vtm::view<node_t>(*_topology, back.address()), static_cast<atom_t>(back.key()));
+            }
+
+            /**
+            *   Evaluate number of keys that are lexicographically less than `key`. Key itself may be absent
+            *   in the trie. Complexity is O(key length) node visits.
+            */
+            template <class AtomContainer>
+            std::uint64_t rank(const AtomContainer& key) const
+                requires (subtree_counters_c)
+            {
+                using node_data_t = typename node_t::NodeData;
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                vtm::StringMemoryManager string_memory_manager(*_topology);
+                std::uint64_t result = 0;
+                auto begin = std::begin(key);
+                auto aend = std::end(key);
+                for (FarAddress node_addr = _root; begin != aend && !node_addr.is_nil(); )
+                {
+                    auto node = vtm::view<node_t>(*_topology, node_addr);
+                    const atom_t step_key = *begin++;
+                    //all entries of smaller keys
+                    for (auto i = node->first(); i && i.value() < step_key; i = node->next(i.value()))
+                        result += entry_weight(node, i.value());
+                    if (!node->presence(step_key))
+                        break;
+                    key_t stem;
+                    node_addr = node->rawc(*_topology, step_key, [&](const node_data_t& node_data) {
+                        if (!node_data._stem.is_nil())
+                            string_memory_manager.get(node_data._stem, std::back_inserter(stem));
+                        return node_data._child;
+                    });
+                    auto [stem_mis, key_mis] = std::mismatch(stem.begin(), stem.end(), begin, aend);
+                    if (stem_mis != stem.end())
+                    { //diverged inside stem, entire entry is either less or bigger than key
+                        if (key_mis != aend && *stem_mis < *key_mis)
+                            result += entry_weight(node, step_key);
+                        break;
+                    }
+                    begin = key_mis;
+                    if (begin == aend) //exact match, nothing from entry is less
+                        break;
+                    if (node->has_value(step_key)) //entry is a prefix of key
+                        ++result;
+                    if (!node->has_child(step_key))
+                        break;
+                }
+                return result;
+            }
+
+            /**
+            *   Find `nth` (zero based) key in order of iteration among keys that start with `prefix`.
+            *   Complexity is O(key length) node visits, so it is cheap way to implement pagination.
+            * \return iterator of found entry or #end() if `nth` exceeds number of keys that start with prefix
+            */
+            template <class AtomContainer>
+            iterator select(const AtomContainer& prefix, std::uint64_t nth) const
+                requires (subtree_counters_c)
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                iterator i(this);
+                FarAddress node_addr = _root;
+                auto begin = std::begin(prefix);
+                auto aend = std::end(prefix);
+                if (begin != aend)
+                {
+                    auto nav = common_prefix(begin, aend, i);
+                    if (begin != aend || !OP::utils::any_of<StemCompareResult::equals, StemCompareResult::string_end>(nav))
+                        return end();
+                    //restore full stem of the entry matched to the prefix
+                    const atom_t back_key = static_cast<atom_t>(i.rat().key());
+                    bool ok;
+                    std::tie(ok, node_addr) = load_iterator(i.rat().address(), i,
+                        [back_key](vtm::ReadonlyAccess<node_t>&) { return NullableAtom{ back_key }; },
+                        &iterator::update_back);
+                    assert(ok);
+                    if (all_set(i.rat().terminality(), Terminality::term_has_data))
+                    {
+                        if (nth == 0)
+                            return i;
+                        --nth;
+                    }
+                }
+                while (!node_addr.is_nil())
+                {
+                    auto node = vtm::view<node_t>(*_topology, node_addr);
+                    NullableAtom chosen;
+                    for (auto k = node->first(); k; k = node->next(k.value()))
+                    {
+                        auto weight = entry_weight(node, k.value());
+                        if (nth < weight)
+                        {
+                            chosen = k;
+                            break;
+                        }
+                        nth -= weight;
+                    }
+                    if (!chosen)
+                        return end();
+                    auto parent_addr = node_addr;
+                    bool ok;
+                    std::tie(ok, node_addr) = load_iterator(parent_addr, i,
+                        [chosen](vtm::ReadonlyAccess<node_t>&) { return chosen; },
+                        &iterator::emplace);
+                    assert(ok);
+                    if (all_set(i.rat().terminality(), Terminality::term_has_data))
+                    {
+                        if (nth == 0)
+                            return i;
+                        --nth;
+                    }
+                }
+                return end();
+            }
+
+            /**
+            *   Evaluate up to `fanout - 1` keys that split the trie into partitions of comparable size.
+            *   Partition `i` covers keys in range `[bounds[i-1], bounds[i])`, the first partition starts from
+            *   the very beginning of trie and the last one continues till the end. Split keys are taken from
+            *   the root level, when root has less than `fanout` entries level-1 entries are used as well.
+            *   Size of partition is estimated by subtree counters of child nodes, when trie doesn't keep
+            *   counters (\sa TrieFeature::subtree_counters) the number of entries of child node is used instead.
+            */
+            std::vector<key_t> partition_bounds(size_t fanout) const
+            {
+                std::vector<key_t> result;
+                if (fanout < 2)
+                    return result;
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                std::vector<std::pair<key_t, size_t>> candidates; //split key + estimated weight
+                size_t total_weight = 0;
+                auto add_candidate = [&](key_t key, size_t weight) {
+                    total_weight += weight;
+                    candidates.emplace_back(std::move(key), weight);
+                };
+                auto child_weight = [&](FarAddress child) -> size_t {
+                    if (child.is_nil())
+                        return 0;
+                    auto child_node = vtm::view<node_t>(*_topology, child);
+                    if constexpr (subtree_counters_c)
+                        return child_node->subtree_count();
+                    else
+                        return child_node->presence_union().count_bits();
+                };
+
+                auto root = vtm::view<node_t>(*_topology, _root);
+                const bool expand = root->presence_union().count_bits() < fanout;
+                for (auto pos = root->first(); pos; pos = root->next(pos.value()))
+                {
+                    iterator i(this);
+                    auto [ok, child] = load_iterator(_root, i,
+                        [&](vtm::ReadonlyAccess<node_t>&) { return pos; }, &iterator::emplace);
+                    assert(ok);
+                    const bool has_value = all_set(i.rat().terminality(), Terminality::term_has_data);
+                    if (!expand || child.is_nil())
+                    {
+                        add_candidate(key_t(1, pos.value()), child_weight(child) + (has_value ? 1 : 0));
+                        continue;
+                    }
+                    //entry with value itself starts sub-range
+                    add_candidate(key_t(1, pos.value()), has_value ? 1 : 0);
+                    auto child_node = vtm::view<node_t>(*_topology, child);
+                    for (auto sub = child_node->first(); sub; sub = child_node->next(sub.value()))
+                    {
+                        iterator sub_i(i);
+                        auto [sub_ok, grand_child] = load_iterator(child, sub_i,
+                            [&](vtm::ReadonlyAccess<node_t>&) { return sub; }, &iterator::emplace);
+                        assert(sub_ok);
+                        key_t split_key = i.key();
+                        split_key.push_back(sub.value());
+                        add_candidate(std::move(split_key), child_weight(grand_child) + 1);
+                    }
+                }
+                //distribute weight evenly
+                const size_t target = std::max<size_t>(1, total_weight / fanout);
+                size_t accumulated = 0;
+                for (const auto& [key, weight] : candidates)
+                {
+                    if (accumulated >= target * (result.size() + 1) && result.size() + 1 < fanout)
+                        result.push_back(key);
+                    accumulated += weight;
+                }
+                return result;
+            }
+
+            /**
+            *   Split keyspace by #partition_bounds to at most `fanout` lazy ranges over disjoint key intervals.
+            *   Ranges go in key order, each of them iterates `const iterator&` like #range does and can be
+            *   consumed independently (for example on separate threads).
+            */
+            auto partitions(size_t fanout) const
+            {
+                auto bounds = partition_bounds(fanout);
+                std::vector<decltype(interval_range(key_t{}, std::optional<key_t>{}))> result;
+                result.reserve(bounds.size() + 1);
+                for (size_t i = 0; i <= bounds.size(); ++i)
+                {
+                    result.emplace_back(interval_range(
+                        i > 0 ? bounds[i - 1] : key_t{},
+                        i < bounds.size() ? std::optional<key_t>(bounds[i]) : std::nullopt));
+                }
+                return result;
+            }
+
+            /**
+            *   Process the trie in parallel. Each of #partitions is passed to `f` on its own `pool` worker,
+            *   so the whole pipeline built by `f` over the partition is evaluated on that worker and nothing
+            *   is buffered except the results. Result is the range of `f` results in key order of partitions.
+            *   Partitions are not pinned to a single version of trie, under concurrent writes they behave
+            *   like any other range of trie.
+            * \tparam TThreads - thread pool (e.g. OP::utils::ThreadPool);
+            * \tparam F - functor `R (const partition_range&)`, where `R` is not void. Functor is copied to
+            *   each worker.
+            */
+            template <class TThreads, class F>
+            auto parallel_range(TThreads& pool, size_t fanout, F f) const
+            {
+                return make_parallel_scan<true>(start_partitions(pool, fanout, std::move(f)));
+            }
+
+            /**
+            *   Same as #parallel_range, but results are yielded in order of accomplishment, so consumer doesn't
+            *   wait for slow partition. Useful for aggregations that don't depend on order.
+            */
+            template <class TThreads, class F>
+            auto parallel_unordered_range(TThreads& pool, size_t fanout, F f) const
+            {
+                return make_parallel_scan<false>(start_partitions(pool, fanout, std::move(f)));
+            }
+
             /**Return range that allows iterate all immediate children of specified prefix*/
             auto children_range(const iterator& of_this) const
             {
@@ -612,9 +1237,7 @@ namespace OP
                 if (pos.key() < dim_t{ 256 })
                 {
                     return node->get_value(*_topology, (atom_t)pos.key(), [this](const auto& ref){
-                        return OP::trie::store_converter::Storage<
-                                typename payload_manager_t::source_payload_t
-                            >::deserialize(*_topology, ref);
+                        return storage_converter_t::deserialize(*_topology, ref);
                     });
                 }
                 op_g.rollback();
@@ -622,8 +1245,63 @@ namespace OP
             }
 
             /**
-            *   Insert string specified by pair [begin, end) and associate value with it.
-            * @param begin start iterator of string to insert.
+            *   Set point of time when entry pointed by `pos` expires. Expired entry stays in the trie until
+            *   it is erased explicitly (\sa TtlSweeper), but lookup with #find_alive doesn't see it anymore.
+            *   Available only for payload managers that keep expiration point (\sa ExpiringValueManager).
+            *   Changing of expiration doesn't modify version of the trie and is not captured by change feed.
+            * \param pos - position of the entry, may be re-synchronized if trie has been changed;
+            * \param expire_at - expiration point, `never_expire_c` to drop expiration;
+            * \return false if `pos` doesn't point to the existing entry.
+            */
+            bool expire(iterator& pos, expiry_t expire_at) requires ExpiringPayloadManager<payload_manager_t>
+            {
+                ensure_mutable();
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                if (!sync_iterator(pos) || pos.is_end())
+                    return false;
+                const auto& back = pos.rat();
+                auto wr_node = vtm::accessor<node_t>(*_topology, back.address());
+                wr_node->raw(*_topology, static_cast<atom_t>(back.key()), [&](auto& node_data) {
+                    payload_manager_t::expire_at(node_data._value, expire_at);
+                    });
+                return true;
+            }
+
+            /**
+            *   \return expiration point of the entry pointed by `pos` or `never_expire_c` if expiration is not set.
+            * \throws std::invalid_argument if `pos` is `end()`.
+            */
+            expiry_t expiry_of(const iterator& pos) const requires ExpiringPayloadManager<payload_manager_t>
+            {
+                if (pos.is_end())
+                    throw std::invalid_argument("position has no value associated");
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                const auto& back = pos._position_stack.back();
+                auto node = vtm::view<node_t>(*_topology, back.address());
+                return node->rawc(*_topology, static_cast<atom_t>(back.key()), [](const auto& node_data) {
+                    return payload_manager_t::expire_at(node_data._value);
+                    });
+            }
+
+            /**
+            *   Same as #find but hides entries which are expired at `now` even if they are not erased yet.
+            * \return iterator of found alive entry or `end()`.
+            */
+            template <class AtomString>
+            iterator find_alive(const AtomString& key, expiry_t now = ExpiryClock::now()) const
+                requires ExpiringPayloadManager<payload_manager_t>
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false);
+                auto found = find(key);
+                if (!found.is_end() && ExpiryClock::is_expired(expiry_of(found), now))
+                    return end();
+                return found;
+            }
+
+            /**
+            *   Insert string specified by pair [begin, end) and associate value with it.
+            * @param begin start iterator of string to insert.
             * @param end end iterator of string to insert.
             * @param value value to associate with inserted string
             * @return pair of iterator and success indicator. When insert succeeded iterator is a position of
@@ -636,11 +1314,16 @@ namespace OP
                 if (begin == aend)
                     return std::make_pair(iterator(this), false); //empty string cannot be inserted
 
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction());
+                ChangeCapture capture(*this, op_g);
                 
                 auto result = std::make_pair(end(), true);
                 result.second = !insert_impl(
                     result.first, begin, aend, std::move(value_assigner));
+                if (result.second)
+                    capture.add(ChangeKind::insert, result.first);
+                capture.seal();
                 op_g.commit();
 
                 return result;
@@ -669,6 +1352,217 @@ namespace OP
                 return insert(b, std::end(container), value);
             }
 
+            /**
+            *   Populate empty trie from the source of pre-sorted key/value pairs. In compare with
+            *   sequential #insert this method doesn't navigate from the root for each key, instead
+            *   nodes are built bottom-up: each node is allocated once with the hash-table sized to
+            *   final number of entries, each stem is written once and TrieResidence header is
+            *   updated once at the end. Everything is done in the single transaction.
+            *
+            *   When `minimize` is set the trie is built as DAWG: since nodes are persisted bottom-up, all
+            *   descendants of a node are already unique at the moment it is persisted, so identical
+            *   subtrees are detected just by content hash of a single node (atoms, stems, values and
+            *   child addresses) and the node that already exists is referenced instead of allocating new one.
+            *   Identical stem strings are shared as well. Such trie is read-only: any further
+            *   modification throws `std::logic_error` (\sa #is_minimized, #ensure_mutable).
+            *
+            *   \param source - flur sequence (or factory of sequence) producing pair-like elements
+            *       `(key, value)` in strictly ascending (lexicographical) order of keys. Empty keys are
+            *       ignored.
+            *   \param minimize - share identical subtrees, requires `value_type` to be equality comparable.
+            *   \return number of entries loaded
+            *   \throws std::invalid_argument if trie is not empty or keys are not strictly ascending
+            */
+            template <class Source>
+            size_t bulk_load(Source&& source, bool minimize = false)
+            {
+                return bulk_load_impl(std::forward<Source>(source), minimize).first;
+            }
+
+            /** Result of #compact_to / #minimize_to */
+            struct CompactionReport
+            {
+                /** Compacted copy of the trie */
+                std::shared_ptr<trie_t> _trie;
+                /** Number of entries copied */
+                std::uint64_t _count = 0;
+                /** Number of nodes allocated in source and target */
+                std::uint64_t _source_nodes = 0, _target_nodes = 0;
+                /** Number of node references resolved to already existing node by #minimize_to */
+                std::uint64_t _shared_nodes = 0;
+                /** Bytes occupied by segments of source and target */
+                std::uint64_t _source_bytes = 0, _target_bytes = 0;
+
+                /** Number of bytes reclaimed by compaction */
+                std::int64_t reclaimed() const noexcept
+                {
+                    return static_cast<std::int64_t>(_source_bytes) - static_cast<std::int64_t>(_target_bytes);
+                }
+            };
+
+            /**
+            *   Rewrite this trie into the fresh storage. Keys are streamed in ascending order into #bulk_load,
+            *   so each node is allocated once, with the hash-table sized to the exact number of entries and
+            *   children are allocated just before their parent. As a result nodes of the same subtree and their
+            *   stems are laid out contiguously and free blocks left by erase are not transferred.
+            *   Source trie is not modified.
+            *   Target transaction is committed after each `chunk_size` keys, so history of changes kept by the
+            *   target segment manager doesn't grow with the size of the trie. Storage becomes a valid trie only
+            *   when method returns, if copy fails the target must be discarded.
+            *
+            *   \param target - segment manager of empty storage, new trie is created there.
+            *   \param chunk_size - number of keys copied in the scope of single transaction.
+            *   \return report with new trie and size of source and target storage.
+            */
+            CompactionReport compact_to(std::shared_ptr<TSegmentManager> target, size_t chunk_size = compaction_chunk_c) const
+            {
+                return copy_to(target, false, chunk_size);
+            }
+
+            /**
+            *   The same as #compact_to, but identical subtrees and stems of the result are shared (\sa #bulk_load).
+            *   Result is a read-only trie, that is served by the same iterators and ranges as regular one.
+            */
+            CompactionReport minimize_to(std::shared_ptr<TSegmentManager> target, size_t chunk_size = compaction_chunk_c) const
+            {
+                return copy_to(target, true, chunk_size);
+            }
+
+            /** Result of #merge_from */
+            struct MergeReport
+            {
+                /** Number of keys that were absent in the target trie */
+                std::uint64_t _added = 0;
+                /** Number of keys presented in both tries, so conflict resolver was invoked */
+                std::uint64_t _conflicts = 0;
+                /** Number of nodes copied as whole subtrees from the source trie */
+                std::uint64_t _grafted_nodes = 0;
+            };
+
+            /**
+            *   Merge all keys of `other` trie into this one. Both tries are walked in lockstep node by node:
+            *   entries that are absent in this trie are grafted together with entire subtree (nodes and stems
+            *   are copied without navigation from the root for each key), so recursion descends only where both
+            *   tries have children. As result cost depends on the overlap of tries rather than size of `other`.
+            *   All changes are done in the single transaction.
+            *
+            *   \param other - source trie, it is not modified and may reside in another segment manager.
+            *   \param conflict - functor `value_type (const value_type& target, const value_type& source)`
+            *       invoked for keys that exist in both tries (\sa merge_policy).
+            *   \throws std::invalid_argument if `other` is this trie.
+            */
+            template <class FConflict = merge_policy::take_source>
+            MergeReport merge_from(const trie_t& other, FConflict conflict = FConflict{})
+            {
+                ensure_mutable();
+                if (&other == this)
+                    throw std::invalid_argument("trie cannot be merged into itself");
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction());
+                MergeContext<FConflict> context{ other, conflict };
+                context._report._added = merge_node(_root, other._root, context);
+                std::uint64_t filter_keys = 0;
+                _topology->template slot<TrieResidence>()
+                    .update([&, new_ver = ++this->_version](auto& header) {
+                        header._count += context._report._added;
+                        header._nodes_allocated += context._delta._nodes_allocated;
+                        header._version = new_ver;
+                        filter_keys = header._filter_added += context._report._added;
+                    });
+                fit_filter(filter_keys);
+                op_g.commit();
+                return context._report;
+            }
+
+            /**
+            *   Writer that queues mutations and applies them to the trie in a single pass (\sa #batch).
+            *   On #apply queued operations are stably sorted by key, so operations over the same key keep
+            *   the order they were queued in. Since neighbour keys share prefix, navigation for the next key
+            *   starts from the deepest common position of the previous one instead of the root. All changes are
+            *   done in the single transaction and TrieResidence header (number of items, number of nodes and
+            *   version) is updated once per batch.
+            */
+            class Batch
+            {
+            public:
+                explicit Batch(std::shared_ptr<trie_t> trie) noexcept
+                    : _trie(std::move(trie))
+                {
+                }
+
+                /** Queue insert of `key` with `value`. Has no effect if key already exists at the moment of apply */
+                template <class AtomContainer>
+                Batch& insert(const AtomContainer& key, value_type value)
+                {
+                    _operations.push_back(Operation{
+                        key_t(std::begin(key), std::end(key)), Kind::insert, std::move(value) });
+                    return *this;
+                }
+
+                /** Queue insert or update of `key` with `value` */
+                template <class AtomContainer>
+                Batch& upsert(const AtomContainer& key, value_type value)
+                {
+                    _operations.push_back(Operation{
+                        key_t(std::begin(key), std::end(key)), Kind::upsert, std::move(value) });
+                    return *this;
+                }
+
+                /** Queue erase of `key`. Has no effect if key doesn't exist at the moment of apply */
+                template <class AtomContainer>
+                Batch& erase(const AtomContainer& key)
+                {
+                    _operations.push_back(Operation{
+                        key_t(std::begin(key), std::end(key)), Kind::erase, std::nullopt });
+                    return *this;
+                }
+
+                /** Number of queued operations */
+                size_t size() const noexcept
+                {
+                    return _operations.size();
+                }
+
+                /**
+                *   Apply all queued operations and clear the queue. Operations with empty key are ignored.
+                *   \return number of keys that were inserted, updated or erased
+                */
+                size_t apply()
+                {
+                    std::stable_sort(_operations.begin(), _operations.end(),
+                        [](const Operation& left, const Operation& right) {
+                            return left._key < right._key;
+                        });
+                    size_t modified = _trie->apply_batch(_operations);
+                    _operations.clear();
+                    return modified;
+                }
+
+            private:
+                friend trie_t;
+
+                enum class Kind
+                {
+                    insert, upsert, erase
+                };
+
+                struct Operation
+                {
+                    key_t _key;
+                    Kind _kind;
+                    std::optional<value_type> _value;
+                };
+
+                std::shared_ptr<trie_t> _trie;
+                std::vector<Operation> _operations;
+            };
+
+            /** Create writer that accumulates mutations and applies them in one pass (\sa Batch) */
+            Batch batch()
+            {
+                return Batch(this->shared_from_this());
+            }
+
             /**
             *  Insert key-value below the prefix specified by parameter `of_prefix`. In fact on success you 
             *   add the key that looks like concatenation of `of_prefix.key() + atom_string_t(begin, aend)`
@@ -694,7 +1588,9 @@ namespace OP
                 if (begin == aend)
                     return std::make_pair(end(), false); //empty string is not operatable
 
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true/*commit automatically*/);
+                ChangeCapture capture(*this, op_g);
                 key_t fallback_key;
                 auto sync_res = sync_iterator(of_prefix, &fallback_key);
                 if (!sync_res)
@@ -705,6 +1601,8 @@ namespace OP
                 alter_navigation(result.first);
                 result.second = !insert_impl(
                     result.first, begin, aend, std::move(value_factory));
+                if (result.second)
+                    capture.add(ChangeKind::insert, result.first);
                 return result;
             }
 
@@ -755,14 +1653,96 @@ namespace OP
             */
             size_t update(iterator& pos, value_type value)
             {
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                ChangeCapture capture(*this, op_g);
                 
                 if (!sync_iterator(pos) || pos.is_end())
                 { //no entry for previous iterator
                     return 0;
                 }
 
-                return update_impl(pos, std::move(value));
+                const auto updated = update_impl(pos, std::move(value));
+                if (updated)
+                    capture.add(ChangeKind::update, pos);
+                return updated;
+            }
+
+            /**
+            *   Append bytes to the value of existing entry without reading and rewriting it. Available only
+            *   for payload managers that keep values by chunks (\sa BlobValueManager).
+            * \param data - string-like container of chars to append;
+            * \return number of items updated (1 or 0).
+            */
+            template <class TStringLike>
+            size_t append_value(iterator& pos, const TStringLike& data) requires BlobPayloadManager<payload_manager_t>
+            {
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                ChangeCapture capture(*this, op_g);
+
+                if (!sync_iterator(pos) || pos.is_end())
+                    return 0;
+                const char* begin = std::data(data);
+                std::uint64_t offset = 0;
+                const auto updated = update_payload_impl(pos, [&](payload_t& dest) {
+                    offset = dest._size;
+                    storage_converter_t::append(*_topology, dest, begin, begin + std::size(data));
+                    });
+                if (updated)
+                    capture.add_append(pos, offset, data);
+                return updated;
+            }
+
+            /**
+            *   Size in bytes of the value of the entry pointed by `pos`, value itself isn't read.
+            * \throws std::invalid_argument if `pos` is `end()`.
+            */
+            std::uint64_t value_size(const iterator& pos) const requires BlobPayloadManager<payload_manager_t>
+            {
+                if (pos.is_end())
+                    throw std::invalid_argument("position has no value associated");
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                const auto& back = pos._position_stack.back();
+                auto node = vtm::view<node_t>(*_topology, back.address());
+                return node->get_value(*_topology, static_cast<atom_t>(back.key()),
+                    [](const payload_t& ref) { return ref._size; });
+            }
+
+            /**
+            *   Zero-copy access to the value of the entry pointed by `pos`. Result is LazyRange of
+            *   `const ReadonlyMemoryChunk&`, each chunk is loaded only when range reaches it. Range reflects value
+            *   at the moment of this call, so it must not be used after the value has been changed or erased.
+            * \throws std::invalid_argument if `pos` is `end()`.
+            */
+            auto value_chunks(const iterator& pos) const requires BlobPayloadManager<payload_manager_t>
+            {
+                if (pos.is_end())
+                    throw std::invalid_argument("position has no value associated");
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                const auto& back = pos._position_stack.back();
+                auto node = vtm::view<node_t>(*_topology, back.address());
+                BlobAddress blob = node->get_value(*_topology, static_cast<atom_t>(back.key()),
+                    [](const payload_t& ref) { return ref; });
+                return OP::flur::make_lazy_range(
+                    OP::flur::SimpleFactory<BlobChunkSequence<storage_converter_t>,
+                        std::shared_ptr<const void>, vtm::SegmentManager*, BlobAddress>(
+                            this->shared_from_this(), &_topology->segment_manager(), blob));
+            }
+
+            /**
+            *   Train dictionary shared by all values of the trie, available only for payload managers that
+            *   compress values (\sa CompressedValueManager). Dictionary can be trained only once, values inserted
+            *   before training stay readable but are not re-compressed.
+            * \param samples - range of typical values, for example first few hundreds of values to insert;
+            * \throws std::logic_error if dictionary has been already trained.
+            */
+            template <class Samples>
+            void train_compression(const Samples& samples) requires CompressingPayloadManager<payload_manager_t>
+            {
+                ensure_mutable();
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                payload_manager_t::train(*_topology, samples);
             }
 
             /**
@@ -805,7 +1785,9 @@ namespace OP
             {
                 if (begin == aend)
                     return std::make_pair(end(), false); //empty string is not operatable
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true/*commit automatically*/);
+                ChangeCapture capture(*this, op_g);
                 key_t fallback_key;
                 
                 if (!sync_iterator(of_prefix, &fallback_key))
@@ -824,6 +1806,7 @@ namespace OP
                     result.second = false;//already exists
                     update_impl(result.first, std::move(value));
                 }
+                capture.add(result.second ? ChangeKind::insert : ChangeKind::update, result.first);
                 return result;
             }
 
@@ -837,12 +1820,15 @@ namespace OP
             {
                 if (count) { *count = 0; }
 
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager()
                     .begin_transaction(), true);
+                ChangeCapture capture(*this, op_g);
 
                 if (!sync_iterator(pos) || pos.is_end())
                     return end();
 
+                capture.add(ChangeKind::erase, pos);
                 return erase_impl(pos, count);
             }
 
@@ -861,11 +1847,15 @@ namespace OP
             */
             size_t prefixed_erase_all(iterator& prefix, bool erase_prefix = true)
             {
+                ensure_mutable();
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                ChangeCapture capture(*this, op_g);
                 if (!sync_iterator(prefix) || prefix.is_end())
                 { 
                     return 0;
                 }
+                capture.add(ChangeKind::prefixed_erase_all, prefix.key(), key_t{}, erase_prefix);
 
                 auto rat = prefix.rat();//not a ref!
                 if (erase_prefix && is_not_set(rat.terminality(), Terminality::term_has_child))
@@ -891,11 +1881,13 @@ namespace OP
                     erased_terminals += wr_node->erase_all(*_topology, to_process);
                     remove_node(wr_node);
                 }
+                adjust_subtree_count(prefix, -static_cast<std::int64_t>(erased_terminals));
                 const auto& new_back = prefix.rat(
                     terminality_and(~Terminality::term_has_child));//avoid way-down
                 //need additional variable since #erase will decrement counter as well
                 auto effective_decrease_number = -static_cast<std::make_signed_t<size_t>>(erased_terminals);
-                if (erase_prefix && all_set(new_back.terminality(), Terminality::term_has_data))
+                const bool prefix_erased = erase_prefix && all_set(new_back.terminality(), Terminality::term_has_data);
+                if (prefix_erased)
                 {
                     size_t counter = 0;
                     prefix = erase_impl(prefix, &counter);
@@ -910,8 +1902,8 @@ namespace OP
                         prefix._version = this->_version;
                     });
 
-                if (!prefix.is_end())
-                {
+                if (!prefix_erased && !prefix.is_end())
+                { //when prefix is erased iterator already points to the next entry with own children
                     prefix.rat(
                         node_version(parent_wr_node->_version),
                         terminality_and(~Terminality::term_has_child));
@@ -927,6 +1919,7 @@ namespace OP
             template <class StringLike>
             size_t prefixed_key_erase_all(const StringLike& prefix)
             {
+                WriterScope writer_g(*this);
                 OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
                 size_t result = 0;
                 for (iterator it(this->lower_bound(prefix)); it != this->end(); )
@@ -955,6 +1948,57 @@ namespace OP
                 return result;
             }
 
+            /**
+            *   Remove all keys from half-open interval [`from`, `to`). Only nodes on the paths of both boundaries
+            *   are visited entry by entry, subtrees that are entirely inside interval are released without
+            *   visiting their keys one by one. Released nodes are returned to the node manager in a single batch
+            *   and counters of the trie are updated once.
+            * \return number of erased keys
+            */
+            template <class AtomContainerFrom, class AtomContainerTo>
+            size_t erase_range(const AtomContainerFrom& from, const AtomContainerTo& to)
+            {
+                ensure_mutable();
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                ChangeCapture capture(*this, op_g);
+                const key_t lo(std::begin(from), std::end(from)), hi(std::begin(to), std::end(to));
+                if (!(lo < hi))
+                    return 0;
+                std::vector<FarAddress> released;
+                bool root_empty = false;
+                const auto erased = erase_range_impl(_root,
+                    RangeBound{ lo.empty(), lo.begin(), lo.end() },
+                    RangeBound{ false, hi.begin(), hi.end() },
+                    released, root_empty);
+                _topology->template slot<node_manager_t>().deallocate_n(released.data(), released.size());
+                const std::uint64_t new_ver = ++this->_version;
+                _topology->template slot<TrieResidence>()
+                    .update([&](auto& header) {
+                        header._count -= erased;
+                        header._nodes_allocated -= released.size();
+                        header._version = new_ver;
+                    });
+                if (erased)
+                    capture.add(ChangeKind::erase_range, lo, hi);
+                return static_cast<size_t>(erased);
+            }
+
+            /**
+            *   Count keys from half-open interval [`from`, `to`). Uses subtree counters of nodes (\sa #rank), so
+            *   complexity is O(length of `from` + length of `to`).
+            */
+            template <class AtomContainerFrom, class AtomContainerTo>
+            std::uint64_t count_range(const AtomContainerFrom& from, const AtomContainerTo& to) const
+                requires (subtree_counters_c)
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                const key_t lo(std::begin(from), std::end(from)), hi(std::begin(to), std::end(to));
+                if (!(lo < hi))
+                    return 0;
+                return rank(hi) - rank(lo);
+            }
+
             /**
             *   Allows to apply multiple modification operations in a transaction. In fact this just decoration
             * for \code
@@ -997,13 +2041,183 @@ namespace OP
 
         private:
 
+            /** Changes of TrieResidence counters accumulated by #Batch to be written once per batch */
+            struct ResidenceDelta
+            {
+                std::int64_t _count = 0;
+                std::int64_t _nodes_allocated = 0;
+                std::uint64_t _filter_added = 0;
+            };
+
+            /**
+            *   Holds #_writers_lock shared for the scope of modifying operation, so #snapshot can block writers
+            *   while copying. Nested operations of the same thread (for example prefixed_insert that falls back
+            *   to insert) don't lock again, since std::shared_mutex isn't recursive.
+            */
+            struct WriterScope
+            {
+                explicit WriterScope(const trie_t& owner)
+                {
+                    if (!held_by_this_thread(owner))
+                    {
+                        owner._writers_lock.lock_shared();
+                        held().push_back(&owner);
+                        _owner = &owner;
+                    }
+                }
+
+                WriterScope(const WriterScope&) = delete;
+                WriterScope& operator=(const WriterScope&) = delete;
+
+                ~WriterScope()
+                {
+                    if (_owner)
+                    {
+                        auto& locks = held();
+                        locks.erase(std::find(locks.begin(), locks.end(), _owner));
+                        _owner->_writers_lock.unlock_shared();
+                    }
+                }
+
+                static bool held_by_this_thread(const trie_t& owner)
+                {
+                    const auto& locks = held();
+                    return std::find(locks.begin(), locks.end(), &owner) != locks.end();
+                }
+
+            private:
+                const trie_t* _owner = nullptr;
+
+                static std::vector<const trie_t*>& held()
+                {
+                    thread_local std::vector<const trie_t*> locks;
+                    return locks;
+                }
+            };
+
+            /**
+            *   Collects change records of single operation. At exit of scope (or explicit #seal) records are
+            *   tagged with the version the operation has stored to the trie header and passed to the transaction
+            *   of the operation, so they are written to #_change_feed only at commit of the outermost transaction.
+            *   Must be declared after TransactionGuard of the operation, if operation commits explicitly #seal
+            *   must precede the commit. Records are dropped if operation exits by exception.
+            */
+            struct ChangeCapture
+            {
+                ChangeCapture(const trie_t& owner, OP::vtm::TransactionGuard& op_g) noexcept
+                    : _owner(owner)
+                    , _op_g(op_g)
+                    , _feed(owner._change_feed)
+                    , _exceptions(std::uncaught_exceptions())
+                {
+                }
+
+                ChangeCapture(const ChangeCapture&) = delete;
+                ChangeCapture& operator=(const ChangeCapture&) = delete;
+
+                ~ChangeCapture()
+                {
+                    if (std::uncaught_exceptions() == _exceptions)
+                        seal();
+                }
+
+                /** Pass collected records to the transaction of operation, must be called before commit */
+                void seal()
+                {
+                    if constexpr (ChangeCodec<value_type>::supported_c)
+                    {
+                        if (_records.empty())
+                            return;
+                        // header is locked by the operation, so it keeps exactly the version produced
+                        const std::uint64_t version = _owner._topology->template slot<TrieResidence>()
+                            .get_header()._version;
+                        for (auto& record : _records)
+                            record._version = version;
+                        auto write = [feed = _feed, records = std::exchange(_records, {})]() {
+                            for (const auto& record : records)
+                                feed->write(record);
+                        };
+                        if (auto transaction = _op_g.transaction(); transaction)
+                            transaction->on_commit(std::move(write));
+                        else
+                            write();
+                    }
+                }
+
+                /** Capture key (and value for insert/update) the iterator points to */
+                void add(ChangeKind kind, const iterator& pos)
+                {
+                    if (!_feed)
+                        return;
+                    change_record_t record;
+                    record._kind = kind;
+                    record._key.append(pos.key().begin(), pos.key().end());
+                    if (kind == ChangeKind::insert || kind == ChangeKind::update)
+                        record._value.emplace(pos.value());
+                    push(std::move(record));
+                }
+
+                /** Capture only bytes appended at `offset`, so the whole value isn't read back */
+                template <class TStringLike>
+                void add_append(const iterator& pos, std::uint64_t offset, const TStringLike& data)
+                {
+                    if (!_feed)
+                        return;
+                    change_record_t record;
+                    record._kind = ChangeKind::append;
+                    record._key.append(pos.key().begin(), pos.key().end());
+                    record._value.emplace(std::begin(data), std::end(data));
+                    record._offset = offset;
+                    push(std::move(record));
+                }
+
+                template <class AtomStringFrom, class AtomStringTo>
+                void add(ChangeKind kind, const AtomStringFrom& key, const AtomStringTo& key_to, bool erase_prefix = false)
+                {
+                    if (!_feed)
+                        return;
+                    change_record_t record;
+                    record._kind = kind;
+                    record._key.append(std::begin(key), std::end(key));
+                    record._key_to.append(std::begin(key_to), std::end(key_to));
+                    record._erase_prefix = erase_prefix;
+                    push(std::move(record));
+                }
+
+            private:
+                /** Record that cannot be written at commit fails the whole operation, so it is rolled back */
+                void push(change_record_t&& record)
+                {
+                    if (!_feed->fits(record))
+                    {
+                        _op_g.rollback();
+                        throw std::length_error("change record exceeds segment of the change feed log");
+                    }
+                    _records.emplace_back(std::move(record));
+                }
+
+                const trie_t& _owner;
+                OP::vtm::TransactionGuard& _op_g;
+                std::shared_ptr<ChangeFeed> _feed;
+                const int _exceptions;
+                std::vector<change_record_t> _records;
+            };
+
             using node_manager_t = vtm::FixedSizeMemoryManager<node_t, initial_node_count>;
 
-            using topology_t = vtm::SegmentTopology<
-                TrieResidence,
-                node_manager_t,
-                vtm::HeapManagerSlot/*Memory manager must go last*/
-            >;
+            using topology_t = std::conditional_t<membership_filter_c,
+                typename details::trie_topology<
+                    typename details::payload_slots<payload_manager_t>::type,
+                    TrieResidence,
+                    MembershipFilter,
+                    node_manager_t
+                >::type,
+                typename details::trie_topology<
+                    typename details::payload_slots<payload_manager_t>::type,
+                    TrieResidence,
+                    node_manager_t
+                >::type
+            >; /*Memory manager goes last*/
             std::unique_ptr<topology_t> _topology;
 
             /** This variable is a global version indicator, since 
@@ -1016,14 +2230,25 @@ namespace OP
             * (never rolled back)
             */
             std::atomic<std::uint64_t> _version = 0;
+
+            /** Shared by each modifying operation (\sa WriterScope), exclusively locked by #snapshot */
+            mutable std::shared_mutex _writers_lock;
             
             /** Cached result of root node to avoid often referencing to 
             * persisted TrieResidence::TrieHeader::_root
             */ 
             FarAddress _root = {};
 
+            /** Cached TrieResidence::TrieHeader::_minimized, when true nodes may be shared, so any
+            * modification is prohibited
+            */
+            bool _minimized = false;
+
+            /** Optional change-data-capture feed (\sa #change_feed) */
+            std::shared_ptr<ChangeFeed> _change_feed;
+
         private:
-            Trie(std::shared_ptr<TSegmentManager>& segments) noexcept
+            Trie(std::shared_ptr<TSegmentManager>& segments)
                 : _topology{ std::make_unique<topology_t>(segments) }
             {
 
@@ -1033,15 +2258,19 @@ namespace OP
             * \param level - the hint what level of trie this node belongs. 0 - is 
             *   for root node, for most cases default (1) is a good hint how many 
             *   storage entries to allocate
+            * \param batch - when not null header update is postponed to the end of batch
+            * \param parent - address of node that will refer the new one, allows to allocate child close to
+            *   the parent so descending touches fewer pages. Nil address means no preference.
             */
-            FarAddress new_node(size_t level = 1)
+            FarAddress new_node(size_t level = 1, ResidenceDelta* batch = nullptr, FarAddress parent = FarAddress{})
             {
                 TrieOptions options; //@! temp - just default impl. Need add heuristic to allocate mem according to level
-                auto node_addr = _topology->template slot<node_manager_t> ()
-                    .allocate(options.init_node_size(level));
-
-                auto wr_node = vtm::accessor<node_t>(*_topology, node_addr);
-                wr_node->create_interior(*_topology);
+                auto node_addr = make_node(options.init_node_size(level), parent);
+                if (batch)
+                {
+                    ++batch->_nodes_allocated;
+                    return node_addr;
+                }
                 _topology->template slot<TrieResidence>()
                     .update([this](auto& header) {
                         ++header._nodes_allocated;
@@ -1049,11 +2278,245 @@ namespace OP
                 return node_addr;
             }
 
-            void remove_node(vtm::WritableAccess<node_t>& wr_node)
+            /** Allocate node of specific capacity without touching TrieResidence counters.
+            * It is assumed that exists outer transaction scope.
+            */
+            FarAddress make_node(dim_t capacity, FarAddress parent = FarAddress{})
+            {
+                auto node_addr = _topology->template slot<node_manager_t> ()
+                    .allocate_near(parent, capacity);
+
+                auto wr_node = vtm::accessor<node_t>(*_topology, node_addr);
+                wr_node->create_interior(*_topology);
+                return node_addr;
+            }
+
+            /**
+            *   Helper for #bulk_load. Since keys arrive in ascending order, only nodes along the path of
+            *   the last appended key are pending (kept in memory), all others are already persisted.
+            *   Pending node is persisted as soon as the next key diverges above it, at this moment
+            *   exact number of entries is known, so node is allocated with the fitting capacity.
+            */
+            struct BulkBuilder
+            {
+                using stem_address_t = typename node_t::stem_str_address_t;
+
+                struct Entry
+                {
+                    atom_t _key;
+                    key_t _stem;
+                    std::optional<value_type> _value;
+                    FarAddress _child;
+                };
+
+                struct PendingNode
+                {
+                    /** length of key prefix that leads to this node */
+                    size_t _depth;
+                    std::vector<Entry> _entries;
+                };
+
+                /**
+                * \param minimize - reuse already persisted node with the same content instead of
+                *   allocating new one, and share identical stems
+                */
+                BulkBuilder(trie_t& owner, bool minimize)
+                    : _owner(owner)
+                    , _minimize(minimize)
+                {
+                    _pending.push_back(PendingNode{ 0, {} }); //root
+                }
+
+                void append(key_t key, const value_type& value)
+                {
+                    if (key.empty())
+                        return; //empty string cannot be inserted
+                    size_t common = 0;
+                    if (_count)
+                    {
+                        auto [prev_it, key_it] = std::mismatch(
+                            _previous.begin(), _previous.end(), key.begin(), key.end());
+                        if (key_it == key.end() //duplicate or shorter than previous
+                            || (prev_it != _previous.end()
+                                && static_cast<atom_t>(*key_it) < static_cast<atom_t>(*prev_it)))
+                            throw std::invalid_argument("bulk_load expects strictly ascending keys");
+                        common = static_cast<size_t>(prev_it - _previous.begin());
+                    }
+                    //everything deeper than common part is complete
+                    while (_pending.size() > 1 && _pending.back()._depth > common)
+                        flush_back();
+
+                    auto& top = _pending.back();
+                    if (top._entries.empty() || common == top._depth)
+                    { //new sibling in the same node
+                        top._entries.push_back(make_entry(key, top._depth, value));
+                    }
+                    else
+                    {
+                        auto& last = top._entries.back();
+                        PendingNode child{ common, {} };
+                        const size_t stem_end = top._depth + 1 + last._stem.size();
+                        if (common < stem_end)
+                        { //split stem of last entry, the tail goes to the new child
+                            const size_t in_stem = common - top._depth - 1;
+                            child._entries.push_back(Entry{
+                                static_cast<atom_t>(last._stem[in_stem]),
+                                last._stem.substr(in_stem + 1),
+                                std::move(last._value),
+                                last._child });
+                            last._stem.resize(in_stem);
+                            last._value.reset();
+                            last._child = FarAddress{};
+                        }
+                        else
+                        { //previous key is a prefix of current
+                            assert(common == stem_end && last._value && last._child.is_nil());
+                        }
+                        child._entries.push_back(make_entry(key, common, value));
+                        _pending.push_back(std::move(child)); //note `top` and `last` are invalid there
+                    }
+                    _previous = std::move(key);
+                    ++_count;
+                }
+
+                /** Persist all pending nodes.
+                * \return pair of loaded entries and allocated nodes
+                */
+                std::pair<std::uint64_t, std::uint64_t> finish()
+                {
+                    while (_pending.size() > 1)
+                        flush_back();
+                    //root node already exists, just populate it
+                    auto wr_root = vtm::accessor<node_t>(*_owner._topology, _owner._root);
+                    populate(*wr_root, _pending.back());
+                    _pending.back()._entries.clear();
+                    return { _count, _nodes };
+                }
+
+                /** Number of node references resolved to already persisted node */
+                std::uint64_t shared_nodes() const noexcept
+                {
+                    return _shared;
+                }
+
+            private:
+                static Entry make_entry(const key_t& key, size_t depth, const value_type& value)
+                {
+                    return Entry{
+                        static_cast<atom_t>(key[depth]), key.substr(depth + 1), value, FarAddress{} };
+                }
+
+                void flush_back()
+                {
+                    auto& pending = _pending.back();
+                    FarAddress addr{};
+                    std::size_t signature = 0;
+                    if constexpr (std::equality_comparable<value_type>)
+                    {
+                        if (_minimize)
+                        {
+                            signature = content_hash(pending._entries);
+                            auto [same, last] = _unique.equal_range(signature);
+                            for (; same != last; ++same)
+                            {
+                                if (std::equal(
+                                    pending._entries.begin(), pending._entries.end(),
+                                    same->second.first.begin(), same->second.first.end(),
+                                    [](const Entry& left, const Entry& right) {
+                                        return left._key == right._key && left._stem == right._stem
+                                            && left._value == right._value && left._child == right._child;
+                                    }))
+                                {
+                                    addr = same->second.second;
+                                    ++_shared;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                    if (addr.is_nil())
+                    {
+                        addr = _owner.make_node(containers::details::fit_capacity(
+                            static_cast<dim_t>(pending._entries.size())));
+                        auto wr_node = vtm::accessor<node_t>(*_owner._topology, addr);
+                        populate(*wr_node, pending);
+                        ++_nodes;
+                        if (_minimize)
+                            _unique.emplace(signature, std::make_pair(std::move(pending._entries), addr));
+                    }
+                    _pending.pop_back();
+                    _pending.back()._entries.back()._child = addr;
+                }
+
+                void populate(node_t& node, PendingNode& pending)
+                {
+                    for (auto& entry : pending._entries)
+                    {
+                        node.place(*_owner._topology, entry._key,
+                            make_stem(entry._stem),
+                            entry._child, entry._value.has_value(),
+                            [&](payload_t& dest) {
+                                storage_converter_t::serialize(*_owner._topology, *entry._value, dest);
+                            });
+                    }
+                }
+
+                stem_address_t make_stem(const key_t& stem)
+                {
+                    if (stem.empty())
+                        return {};
+                    vtm::StringMemoryManager str_manager(*_owner._topology);
+                    if (!_minimize)
+                        return str_manager.smart_insert(stem.begin(), stem.end());
+                    auto found = _stems.find(stem);
+                    if (found == _stems.end())
+                        found = _stems.emplace(stem, str_manager.smart_insert(stem.begin(), stem.end())).first;
+                    return found->second;
+                }
+
+                /** FNV-1a over atoms, stems, child addresses and value presence. Values are compared
+                * on collision only, so no hash of `value_type` is needed */
+                static std::size_t content_hash(const std::vector<Entry>& entries) noexcept
+                {
+                    std::uint64_t h = 0xcbf29ce484222325ull;
+                    auto mix = [&](std::uint64_t v) {
+                        h ^= v;
+                        h *= 0x100000001b3ull;
+                    };
+                    for (const auto& entry : entries)
+                    {
+                        mix(entry._key);
+                        for (auto atom : entry._stem)
+                            mix(atom);
+                        mix(entry._stem.size());
+                        mix(entry._value.has_value());
+                        mix(entry._child.address);
+                    }
+                    return static_cast<std::size_t>(h);
+                }
+
+                trie_t& _owner;
+                const bool _minimize;
+                std::vector<PendingNode> _pending;
+                key_t _previous;
+                std::uint64_t _count = 0;
+                std::uint64_t _nodes = 0;
+                std::uint64_t _shared = 0;
+                /** persisted nodes by content hash, used when `_minimize` only */
+                std::unordered_multimap<std::size_t, std::pair<std::vector<Entry>, FarAddress>> _unique;
+                std::map<key_t, stem_address_t> _stems;
+            };
+
+            void remove_node(vtm::WritableAccess<node_t>& wr_node, ResidenceDelta* batch = nullptr)
             {
                 wr_node->destroy_interior(*_topology);
                 _topology->template slot<node_manager_t>().deallocate(
                     wr_node.address());
+                if (batch)
+                {
+                    --batch->_nodes_allocated;
+                    return;
+                }
                 _topology->template slot<TrieResidence>()
                     .update([this](auto& header) {
                         --header._nodes_allocated;
@@ -1069,7 +2532,7 @@ namespace OP
             {
                 const auto& back = break_position.rat();
                 //create new node to place result
-                FarAddress new_node_addr = new_node(break_position.deep());
+                FarAddress new_node_addr = new_node(break_position.deep(), nullptr, back.address());
                 atom_t key = static_cast<atom_t>(back.key());
                 dim_t in_stem_pos = back.stem_size();
                 wr_node.move_to(*_topology, key, in_stem_pos, new_node_addr);
@@ -1083,35 +2546,119 @@ namespace OP
             * \return updated version of trie (matched to current transaction)
             */
             template <class FPayloadFactory>
-            std::uint64_t unconditional_insert(iterator& result, FPayloadFactory fassign)
+            std::uint64_t unconditional_insert(iterator& result, FPayloadFactory fassign, ResidenceDelta* batch = nullptr)
+            {
+                const auto& back = result.rat();
+                assert(back.key() < 256);
+                atom_t key = static_cast<atom_t>(back.key());
+                auto wr_node = vtm::accessor<node_t>(*_topology, back.address());
+                assert(back.stem_size() != vtm::dim_nil_c );
+                wr_node->insert(
+                    *_topology, key, 
+                    result._prefix.end() - back.stem_size(), result._prefix.end(),
+                    [&](auto& raw_payload) {
+                        storage_converter_t::serialize(*_topology,
+                            fassign(),
+                            raw_payload
+                        );
+                    });
+                result.rat(
+                    node_version(wr_node->_version),
+                    terminality_or(Terminality::term_has_data)
+                );
+                adjust_subtree_count(result, 1);
+                filter_add(result.key());
+                if (batch)
+                {
+                    ++batch->_count;
+                    ++batch->_filter_added;
+                    return this->_version;
+                }
+                // condition `begin == end` is never happens
+                std::uint64_t version = ++this->_version; // version of trie
+                std::uint64_t filter_keys = 0;
+                _topology->template slot<TrieResidence>()
+                    .update([&](auto& header){
+                        ++header._count; //number of terminals
+                        header._version = version;
+                        filter_keys = ++header._filter_added;
+                    });
+                fit_filter(filter_keys);
+                return version;
+            }
+            /**
+            *   Populate MembershipFilter of bigger size when number of keys added to it (`filter_keys`) exceeds
+            *   the capacity. Filter of max size is kept as is, since re-population wouldn't reduce the false
+            *   positive rate but would scan entire trie on each insert. Must be called in transaction scope when
+            *   all added keys are reachable in the trie.
+            */
+            void fit_filter(std::uint64_t filter_keys)
+            {
+                if constexpr (membership_filter_c)
+                {
+                    const auto& filter = _topology->template slot<MembershipFilter>();
+                    if (filter_keys > filter.capacity() && filter.can_grow())
+                        refill_filter(2 * size());
+                }
+            }
+
+            /** Size MembershipFilter for `expected_keys` and populate it from the actual keys */
+            void refill_filter(std::uint64_t expected_keys)
+            {
+                if constexpr (membership_filter_c)
+                {
+                    auto& filter = _topology->template slot<MembershipFilter>();
+                    filter.reset(_topology->template slot<vtm::HeapManagerSlot>(), expected_keys);
+                    std::uint64_t added = 0;
+                    for (auto i = begin(); in_range(i); next(i), ++added)
+                        filter.add(i.key());
+                    _topology->template slot<TrieResidence>()
+                        .update([&](auto& header) {
+                            header._filter_added = added;
+                        });
+                }
+            }
+
+            /** Add key to MembershipFilter if the trie keeps one */
+            template <class AtomString>
+            void filter_add(const AtomString& key)
+            {
+                if constexpr (membership_filter_c)
+                    _topology->template slot<MembershipFilter>().add(key);
+            }
+
+            /** \return true if key is definitely absent according to MembershipFilter */
+            template <class Atom>
+            bool filter_rejects(Atom begin, Atom end) const
+            {
+                if constexpr (membership_filter_c)
+                    return !_topology->template slot<MembershipFilter>().might_contain(begin, end);
+                else
+                    return false;
+            }
+
+            /** Add `delta` to the subtree counter of each node on the path specified by `path` */
+            void adjust_subtree_count(const iterator& path, std::int64_t delta)
+            {
+                if constexpr (subtree_counters_c)
+                {
+                    for (const auto& position : path._position_stack)
+                    {
+                        auto wr_node = vtm::accessor<node_t>(*_topology, position.address());
+                        wr_node->add_subtree_count(delta);
+                    }
+                }
+            }
+
+            /** \return number of values that start with key of the entry `key` in node `node` */
+            std::uint64_t entry_weight(const vtm::ReadonlyAccess<node_t>& node, atom_t key) const
             {
-                const auto& back = result.rat();
-                assert(back.key() < 256);
-                atom_t key = static_cast<atom_t>(back.key());
-                auto wr_node = vtm::accessor<node_t>(*_topology, back.address());
-                assert(back.stem_size() != vtm::dim_nil_c );
-                wr_node->insert(
-                    *_topology, key, 
-                    result._prefix.end() - back.stem_size(), result._prefix.end(),
-                    [&](auto& raw_payload) {
-                        storage_converter_t::serialize(*_topology,
-                            fassign(),
-                            raw_payload
-                        );
-                    });
-                result.rat(
-                    node_version(wr_node->_version),
-                    terminality_or(Terminality::term_has_data)
-                );
-                // condition `begin == end` is never happens
-                std::uint64_t version = ++this->_version; // version of trie
-                _topology->template slot<TrieResidence>()
-                    .update([&](auto& header){
-                        ++header._count; //number of terminals
-                        header._version = version;
-                    });
-                return version;
+                std::uint64_t result = node->has_value(key) ? 1 : 0;
+                if (node->has_child(key))
+                    result += node_t::subtree_count_of(*_topology, node->get_child(*_topology, key));
+                return result;
             }
+
             /** find first mismatch after position pointed by `iter` and string specified [`begin`, `end`)
             */ 
             template <class AtomIterator>
@@ -1158,6 +2705,7 @@ namespace OP
                     mismatch_result = node->rawc(*_topology, step_key,
                         [&](const node_data_t& node_data) -> StemCompareResult {
                             node_addr = node_data._child;//if exists discover next child node
+                            prefetch_node(node_addr); //let child load while stem is compared
                             StemCompareResult stem_matches = StemCompareResult::equals;
                             if (node_data._stem.is_nil())
                             { // no stem
@@ -1213,7 +2761,7 @@ namespace OP
             template <class FValueEval>
             void insert_mismatch_string_end(
                 vtm::WritableAccess<node_t>& wr_node,
-                iterator& iter, FValueEval&& f_value_eval)
+                iterator& iter, FValueEval&& f_value_eval, ResidenceDelta* batch = nullptr)
             {
                 //assert(!wr_node->has_value(step_key));
                 auto back = iter.rat();//no ref, copy!
@@ -1221,9 +2769,10 @@ namespace OP
                 atom_t step_key = static_cast<atom_t>(back.key());
 
                 wr_node->raw(*_topology, step_key, [&](auto& src_entry){
-                    if (!src_entry._stem.is_nil())
+                    //string may end exactly at the end of stem (entry has only child), then no split is needed
+                    if (!src_entry._stem.is_nil() && back.stem_size() < stem_length(src_entry._stem))
                     {
-                        auto new_node_addr = new_node(iter.node_count() + 1);
+                        auto new_node_addr = new_node(iter.node_count() + 1, batch, back.address());
                         auto target_node = vtm::accessor<node_t>(*_topology, new_node_addr);
                         wr_node->move_from_entry(*_topology, step_key, src_entry, back.stem_size(), target_node);
                     }
@@ -1243,28 +2792,354 @@ namespace OP
                         Terminality::term_has_child | Terminality::term_has_data),
                     node_version(wr_node->_version)
                 );
+                adjust_subtree_count(iter, 1);
+                filter_add(iter.key());
+                if (batch)
+                {
+                    ++batch->_count;
+                    ++batch->_filter_added;
+                    return;
+                }
 
+                std::uint64_t filter_keys = 0;
                 _topology->template slot<TrieResidence>()
-                    .update([new_ver = ++this->_version](auto& header){
+                    .update([&, new_ver = ++this->_version](auto& header){
                         ++header._count; //number of terminals
                         header._version = new_ver; // version of trie
+                        filter_keys = ++header._filter_added;
                     });
+                fit_filter(filter_keys);
             }
             
-            size_t update_impl(iterator& pos, value_type value)
+            /**
+            * \param chunk_size - when not 0 transaction is committed after each `chunk_size` keys. Nodes that
+            *   are already persisted are referenced from the memory only, so trie is consistent at the end.
+            * \return pair of loaded entries and shared nodes
+            */
+            template <class Source>
+            std::pair<size_t, std::uint64_t> bulk_load_impl(Source&& source, bool minimize, size_t chunk_size = 0)
+            {
+                auto& segment_manager = _topology->segment_manager();
+                WriterScope writer_g(*this);
+                std::optional<OP::vtm::TransactionGuard> op_g(std::in_place, segment_manager.begin_transaction());
+                if (size() != 0)
+                    throw std::invalid_argument("bulk_load allowed for empty trie only");
+                if constexpr (!std::equality_comparable<value_type>)
+                {
+                    if (minimize)
+                        throw std::invalid_argument("minimization requires equality comparable values");
+                }
+
+                auto&& seq = OP::flur::details::unpack(std::forward<Source>(source));
+                auto& seq_ref = OP::flur::details::get_reference(seq);
+
+                BulkBuilder builder(*this, minimize);
+                size_t chunk_keys = 0;
+                for (seq_ref.start(); seq_ref.in_range(); seq_ref.next())
+                {
+                    const auto& [src_key, src_value] = seq_ref.current();
+                    builder.append(key_t(std::begin(src_key), std::end(src_key)), src_value);
+                    if (chunk_size && ++chunk_keys == chunk_size)
+                    {
+                        op_g->commit();
+                        op_g.emplace(segment_manager.begin_transaction());
+                        chunk_keys = 0;
+                    }
+                }
+                auto [entries, nodes] = builder.finish();
+
+                _topology->template slot<TrieResidence>()
+                    .update([&, new_ver = ++this->_version](auto& header) {
+                        header._count += entries;
+                        header._nodes_allocated += nodes;
+                        header._version = new_ver;
+                        header._minimized = minimize ? 1 : 0;
+                    });
+                //number of keys is known only now, so filter is populated once with the fitting size
+                refill_filter(entries);
+                op_g->commit();
+                _minimized = minimize;
+                return { entries, builder.shared_nodes() };
+            }
+
+            CompactionReport copy_to(std::shared_ptr<TSegmentManager>& target, bool minimize, size_t chunk_size) const
+            {
+                CompactionReport report;
+                report._trie = create_new(target);
+                std::tie(report._count, report._shared_nodes) = report._trie->bulk_load_impl(range()
+                    >> OP::flur::then::mapping([](const auto& i) {
+                        return std::make_pair(i.key(), i.value());
+                        }),
+                    minimize, chunk_size
+                );
+                auto& source_manager = OP::vtm::resolve_segment_manager(*_topology);
+                report._source_nodes = _topology->template slot<TrieResidence>()
+                    .get_header()._nodes_allocated;
+                report._target_nodes = report._trie->nodes_count();
+                report._source_bytes = static_cast<std::uint64_t>(source_manager.available_segments())
+                    * source_manager.segment_size();
+                report._target_bytes = static_cast<std::uint64_t>(target->available_segments())
+                    * target->segment_size();
+                return report;
+            }
+
+            /** State of #merge_from shared by all levels of recursion */
+            template <class FConflict>
+            struct MergeContext
+            {
+                const trie_t& _other;
+                FConflict& _conflict;
+                /** key of currently processed entry */
+                key_t _path = {};
+                MergeReport _report = {};
+                ResidenceDelta _delta = {};
+            };
+
+            /** Entry of the source node loaded to memory by #merge_from */
+            struct MergeEntry
+            {
+                atom_t _key = 0;
+                key_t _stem = {};
+                std::optional<value_type> _value = std::nullopt;
+                FarAddress _child = {};
+            };
+
+            /** Load all entries of node `node_addr` that belongs to `owner` trie */
+            static std::vector<MergeEntry> load_entries(const trie_t& owner, FarAddress node_addr)
+            {
+                using node_data_t = typename node_t::NodeData;
+                vtm::StringMemoryManager string_memory_manager(*owner._topology);
+                auto node = vtm::view<node_t>(*owner._topology, node_addr);
+                std::vector<MergeEntry> result;
+                for (auto i = node->first(); i; i = node->next(i.value()))
+                {
+                    MergeEntry& entry = result.emplace_back(MergeEntry{ static_cast<atom_t>(i.value()) });
+                    node->rawc(*owner._topology, entry._key, [&](const node_data_t& node_data) {
+                        if (!node_data._stem.is_nil())
+                            string_memory_manager.get(node_data._stem, std::back_inserter(entry._stem));
+                        });
+                    entry._child = node->get_child(*owner._topology, entry._key);
+                    if (node->has_value(entry._key))
+                        entry._value = node->get_value(*owner._topology, entry._key, [&](const auto& ref) {
+                            return storage_converter_t::deserialize(*owner._topology, ref);
+                        });
+                }
+                return result;
+            }
+
+            /** Merge all entries of source node `source_addr` into target node `target_addr`
+            * \return number of added keys
+            */
+            template <class FConflict>
+            std::uint64_t merge_node(FarAddress target_addr, FarAddress source_addr, MergeContext<FConflict>& context)
+            {
+                std::uint64_t added = 0;
+                for (auto& entry : load_entries(context._other, source_addr))
+                    added += merge_entry(target_addr, entry._key, entry._stem.begin(), entry._stem.end(),
+                        entry._value, entry._child, context);
+                return added;
+            }
+
+            /**
+            *   Merge single source entry (`key` followed by stem [`stem_begin`, `stem_end`)) into target node. When
+            *   stems of target and source diverge the target entry is split at the mismatch (as regular insert
+            *   does), then merge continues in the node below.
+            * \return number of added keys
+            */
+            template <class StemIterator, class FConflict>
+            std::uint64_t merge_entry(FarAddress target_addr, atom_t key, StemIterator stem_begin, StemIterator stem_end,
+                const std::optional<value_type>& value, FarAddress source_child, MergeContext<FConflict>& context)
+            {
+                auto wr_node = vtm::accessor<node_t>(*_topology, target_addr);
+                const auto path_size = context._path.size();
+                context._path.push_back(key);
+                std::uint64_t added = 0;
+                if (!wr_node->presence(key))
+                { //absent in target, so graft entire entry
+                    context._path.append(stem_begin, stem_end);
+                    FarAddress child = source_child.is_nil() ? FarAddress{} : graft(source_child, context, added);
+                    wr_node->place(*_topology, key, make_stem(stem_begin, stem_end), child, value.has_value(),
+                        [&](payload_t& dest) {
+                            storage_converter_t::serialize(*_topology, *value, dest);
+                        });
+                    if (value)
+                    {
+                        filter_add(context._path);
+                        ++added;
+                    }
+                    context._path.resize(path_size);
+                    return added; //#place has already updated subtree counter
+                }
+                key_t target_stem;
+                wr_node->raw(*_topology, key, [&](auto& target_entry) {
+                    if (!target_entry._stem.is_nil())
+                        vtm::StringMemoryManager(*_topology).get(target_entry._stem, std::back_inserter(target_stem));
+                    });
+                auto [target_mis, source_mis] = std::mismatch(
+                    target_stem.begin(), target_stem.end(), stem_begin, stem_end);
+                const auto common = static_cast<dim_t>(target_mis - target_stem.begin());
+                if (target_mis != target_stem.end())
+                { //split target entry, so its stem becomes a common part
+                    auto new_node_addr = new_node(path_size + 2, &context._delta, target_addr);
+                    auto target_node = vtm::accessor<node_t>(*_topology, new_node_addr);
+                    wr_node->raw(*_topology, key, [&](auto& target_entry) {
+                        wr_node->move_from_entry(*_topology, key, target_entry, common, target_node);
+                        });
+                }
+                context._path.append(stem_begin, source_mis);
+                if (source_mis == stem_end)
+                {
+                    if (value)
+                    {
+                        if (wr_node->has_value(key))
+                        {
+                            ++context._report._conflicts;
+                            auto current = wr_node->get_value(*_topology, key, [&](const auto& ref) {
+                                return storage_converter_t::deserialize(*_topology, ref);
+                                });
+                            value_type resolved = context._conflict(
+                                static_cast<const value_type&>(current), *value);
+                            wr_node->raw(*_topology, key, [&](auto& target_entry) {
+                                wr_node->set_raw_factory_value(*_topology, key, target_entry, [&](auto& dest) {
+                                    storage_converter_t::reassign(*_topology, resolved, dest);
+                                    });
+                                });
+                        }
+                        else
+                        {
+                            wr_node->raw(*_topology, key, [&](auto& target_entry) {
+                                payload_manager_t::allocate(*_topology, target_entry._value);
+                                wr_node->set_raw_factory_value(*_topology, key, target_entry, [&](payload_t& dest) {
+                                    storage_converter_t::serialize(*_topology, *value, dest);
+                                    });
+                                });
+                            filter_add(context._path);
+                            ++added;
+                        }
+                    }
+                    if (!source_child.is_nil())
+                    {
+                        if (wr_node->has_child(key))
+                            added += merge_node(wr_node->get_child(*_topology, key), source_child, context);
+                        else
+                        {
+                            auto child = graft(source_child, context, added);
+                            wr_node->set_child(*_topology, key, child);
+                        }
+                    }
+                }
+                else
+                { //source entry continues below the target entry
+                    FarAddress child = wr_node->get_child(*_topology, key);
+                    if (child.is_nil())
+                    {
+                        child = new_node(path_size + 2, &context._delta, target_addr);
+                        wr_node->set_child(*_topology, key, child);
+                    }
+                    const atom_t next_key = static_cast<atom_t>(*source_mis);
+                    added += merge_entry(child, next_key, std::next(source_mis), stem_end, value, source_child, context);
+                }
+                wr_node->add_subtree_count(added);
+                context._path.resize(path_size);
+                return added;
+            }
+
+            /** Copy entire subtree of source trie starting from node `source_addr`
+            * \param grafted_values - [in/out] incremented by number of values copied
+            * \return address of the copy
+            */
+            template <class FConflict>
+            FarAddress graft(FarAddress source_addr, MergeContext<FConflict>& context, std::uint64_t& grafted_values)
+            {
+                auto entries = load_entries(context._other, source_addr);
+                //children are copied before parent, so parent gets already known subtree counters
+                for (auto& entry : entries)
+                {
+                    if (entry._child.is_nil())
+                        continue;
+                    const auto path_size = context._path.size();
+                    context._path.push_back(entry._key);
+                    context._path.append(entry._stem);
+                    entry._child = graft(entry._child, context, grafted_values);
+                    context._path.resize(path_size);
+                }
+                auto addr = make_node(containers::details::fit_capacity(static_cast<dim_t>(entries.size())));
+                ++context._delta._nodes_allocated;
+                ++context._report._grafted_nodes;
+                auto wr_node = vtm::accessor<node_t>(*_topology, addr);
+                for (const auto& entry : entries)
+                {
+                    wr_node->place(*_topology, entry._key, make_stem(entry._stem.begin(), entry._stem.end()),
+                        entry._child, entry._value.has_value(),
+                        [&](payload_t& dest) {
+                            storage_converter_t::serialize(*_topology, *entry._value, dest);
+                        });
+                    if (entry._value)
+                    {
+                        key_t key = context._path;
+                        key.push_back(entry._key);
+                        key.append(entry._stem);
+                        filter_add(key);
+                        ++grafted_values;
+                    }
+                }
+                return addr;
+            }
+
+            template <class StemIterator>
+            typename node_t::stem_str_address_t make_stem(StemIterator begin, StemIterator end)
+            {
+                if (begin == end)
+                    return {};
+                return vtm::StringMemoryManager(*_topology).smart_insert(begin, end);
+            }
+
+            /**
+            *   Minimized trie is read-only rather than copy-on-write. Nodes, stems and payloads don't keep
+            *   reference counters, so a writer cannot tell if a node on its path is shared. Un-sharing would
+            *   then have to copy every node of the path on each write and could never release the originals,
+            *   since other paths may still reference them. Counters would change the persisted node layout for
+            *   all tries to serve the rare case, so use #compact_to to get writable copy instead.
+            *   \throws std::logic_error if trie is minimized, so nodes are shared and cannot be modified
+            */
+            void ensure_mutable() const
+            {
+                if (_minimized)
+                    throw std::logic_error("minimized trie is read-only");
+            }
+
+            template <class StemAddress>
+            dim_t stem_length(const StemAddress& stem) const
+            {
+                vtm::StringMemoryManager string_memory_manager(*_topology);
+                return static_cast<dim_t>(
+                    string_memory_manager.get(stem, [](atom_t) -> bool { return true; }));
+            }
+
+            size_t update_impl(iterator& pos, value_type value, ResidenceDelta* batch = nullptr)
+            {
+                return update_payload_impl(pos, [&](payload_t& dest) {
+                    storage_converter_t::reassign(*_topology, value, dest);
+                    }, batch);
+            }
+
+            /** Modify payload of existing entry in place by `f_payload(payload_t&)` */
+            template <class FPayload>
+            size_t update_payload_impl(iterator& pos, FPayload&& f_payload, ResidenceDelta* batch = nullptr)
             {
+                ensure_mutable();
                 const auto& back = pos.rat();
                 assert(all_set(back.terminality(), Terminality::term_has_data));
 
                 auto wr_node = vtm::accessor<node_t>(*_topology, back.address());
                 atom_t up_key = static_cast<atom_t>(back.key());
                 wr_node->raw(*_topology, up_key, [&](auto& node_data) {
-                        wr_node->set_raw_factory_value(*_topology, up_key, node_data, [&](auto& dest) {
-                            storage_converter_t::reassign(*_topology, value, dest);
-                        });
+                        wr_node->set_raw_factory_value(*_topology, up_key, node_data, f_payload);
                 });
 
                 pos.rat(node_version(wr_node->_version));
+                if (batch)
+                    return 1;
                 _topology->template slot<TrieResidence>()
                     .update([&](auto& header){
                         header._version = this->_version;
@@ -1285,8 +3160,10 @@ namespace OP
             */
             template <class AtomIterator, class FValueFactory>
             bool insert_impl(
-                iterator& iter, AtomIterator begin, AtomIterator end, FValueFactory&& value_factory)
+                iterator& iter, AtomIterator begin, AtomIterator end, FValueFactory&& value_factory,
+                ResidenceDelta* batch = nullptr)
             {
+                ensure_mutable();
                 if (iter.is_end())
                 { //start from root node
                     iter.push(
@@ -1313,11 +3190,11 @@ namespace OP
 
                     if (mismatch_result == StemCompareResult::string_end)
                     {
-                        insert_mismatch_string_end(wr_node, iter, std::move(value_factory));
+                        insert_mismatch_string_end(wr_node, iter, std::move(value_factory), batch);
                         return false;
                     }
 
-                    auto new_node_addr = new_node(iter.node_count()+1);
+                    auto new_node_addr = new_node(iter.node_count()+1, batch, back.address());
                     if (mismatch_result == StemCompareResult::stem_end)
                     {
                         assert(is_not_set(back._terminality, Terminality::term_has_child));
@@ -1346,14 +3223,152 @@ namespace OP
                         iter.update_stem(begin, end);
                     }
                 }
-                iter._version = unconditional_insert(iter, std::move(value_factory));
+                iter._version = unconditional_insert(iter, std::move(value_factory), batch);
                 return false;//brand new entry
             }
             
-            iterator erase_impl(iterator& pos, size_t* count = nullptr)
+            /** Boundary of #erase_range relative to some node, `_unbounded` means no restriction from this side */
+            struct RangeBound
+            {
+                bool _unbounded;
+                typename key_t::const_iterator _begin, _end;
+            };
+
+            /** Position of entry (atom + stem) relative to the boundary */
+            enum class BoundOrder
+            {
+                /** entry and all its children are less than boundary */
+                less,
+                /** entry and all its children are greater than boundary */
+                greater,
+                /** entry equals to boundary, so all its children are greater */
+                equal,
+                /** entry is a prefix of boundary, children need to be compared with the rest of boundary */
+                prefix
+            };
+
+            /**
+            *   Recursive part of #erase_range: erases keys of node `node_addr` that are between `lo` (inclusive)
+            *   and `hi` (exclusive). Recursion goes only along the boundary paths, so depth is limited by length
+            *   of boundaries. Destroyed nodes are appended to `released` and must be deallocated by the caller.
+            * \param node_empty - at exit is true if node has no more entries
+            * \return number of erased keys
+            */
+            std::uint64_t erase_range_impl(FarAddress node_addr, RangeBound lo, RangeBound hi,
+                std::vector<FarAddress>& released, bool& node_empty)
+            {
+                using node_data_t = typename node_t::NodeData;
+                auto wr_node = vtm::accessor<node_t>(*_topology, node_addr);
+                vtm::StringMemoryManager string_memory_manager(*_topology);
+                std::uint64_t erased = 0;
+                std::stack<FarAddress> to_process;
+
+                auto first = lo._unbounded ? wr_node->first() : wr_node->next_or_this(*lo._begin);
+                for (auto i = first; i; )
+                {
+                    const atom_t key = i.value();
+                    i = wr_node->next(key); //entry may be erased below
+                    key_t stem;
+                    bool stem_loaded = false;
+                    auto order = [&](const RangeBound& bound, typename key_t::const_iterator& rest) {
+                        if (key != *bound._begin)
+                            return key < *bound._begin ? BoundOrder::less : BoundOrder::greater;
+                        if (!stem_loaded)
+                        {
+                            wr_node->rawc(*_topology, key, [&](const node_data_t& node_data) {
+                                if (!node_data._stem.is_nil())
+                                    string_memory_manager.get(node_data._stem, std::back_inserter(stem));
+                                });
+                            stem_loaded = true;
+                        }
+                        auto [stem_mis, bound_mis] = std::mismatch(stem.begin(), stem.end(), bound._begin + 1, bound._end);
+                        rest = bound_mis;
+                        if (stem_mis != stem.end())
+                            return (bound_mis != bound._end && *stem_mis < *bound_mis)
+                                ? BoundOrder::less : BoundOrder::greater;
+                        return bound_mis == bound._end ? BoundOrder::equal : BoundOrder::prefix;
+                    };
+                    bool take_value = true;
+                    RangeBound child_lo{ true, {}, {} }, child_hi{ true, {}, {} };
+                    if (!lo._unbounded)
+                    {
+                        typename key_t::const_iterator rest;
+                        switch (order(lo, rest))
+                        {
+                        case BoundOrder::less:
+                            continue;
+                        case BoundOrder::prefix:
+                            take_value = false;
+                            child_lo = RangeBound{ false, rest, lo._end };
+                            break;
+                        default: //all keys of entry are not less than `lo`
+                            break;
+                        }
+                    }
+                    if (!hi._unbounded)
+                    {
+                        typename key_t::const_iterator rest;
+                        auto hi_order = order(hi, rest);
+                        if (hi_order == BoundOrder::greater || hi_order == BoundOrder::equal)
+                            break; //this and all following entries are not less than `hi`
+                        if (hi_order == BoundOrder::prefix)
+                            child_hi = RangeBound{ false, rest, hi._end };
+                    }
+                    const bool has_value = wr_node->has_value(key);
+                    take_value = take_value && has_value;
+                    if (!wr_node->has_child(key))
+                    {
+                        if (take_value)
+                            erased += wr_node->erase_entry(*_topology, key, to_process);
+                        continue;
+                    }
+                    if (child_lo._unbounded && child_hi._unbounded && (take_value || !has_value))
+                    { //entire subtree is inside the range, values of subtree are counted on release
+                        erased += wr_node->erase_entry(*_topology, key, to_process);
+                        continue;
+                    }
+                    bool child_empty = false;
+                    if (child_lo._unbounded && child_hi._unbounded)
+                    { //value stays, all children go
+                        child_empty = true;
+                    }
+                    else
+                        erased += erase_range_impl(
+                            wr_node->get_child(*_topology, key), child_lo, child_hi, released, child_empty);
+                    if (child_empty && !take_value && has_value)
+                    {
+                        to_process.push(wr_node->get_child(*_topology, key));
+                        wr_node->remove_child(*_topology, key);
+                    }
+                    else if (child_empty)
+                        erased += wr_node->erase_entry(*_topology, key, to_process);
+                    else if (take_value)
+                    {
+                        wr_node->erase(*_topology, key, true);
+                        ++erased;
+                    }
+                }
+                //release detached subtrees without recursion
+                while (!to_process.empty())
+                {
+                    auto sub_addr = to_process.top();
+                    to_process.pop();
+                    auto sub_node = vtm::accessor<node_t>(*_topology, sub_addr);
+                    erased += sub_node->erase_all(*_topology, to_process);
+                    sub_node->destroy_interior(*_topology);
+                    released.push_back(sub_addr);
+                }
+                wr_node->add_subtree_count(-static_cast<std::int64_t>(erased));
+                node_empty = wr_node->presence_first_set() == vtm::dim_nil_c;
+                return erased;
+            }
+
+            iterator erase_impl(iterator& pos, size_t* count = nullptr, ResidenceDelta* batch = nullptr)
             {
+                ensure_mutable();
                 auto result{ pos };
                 _next(result);
+                adjust_subtree_count(pos, -1);
                 bool erase_child_and_exit = false; //flag mean stop iteration
 
                 for (bool first = true; pos.node_count(); pos.pop(), first = false)
@@ -1381,17 +3396,22 @@ namespace OP
                     //remove entire node if it is not a root
                     if (back.address() != this->_root)
                     {
-                        remove_node(wr_node);
+                        remove_node(wr_node, batch);
                         erase_child_and_exit = true;
                     }
                 }
+                if (count) { ++*count; }
+                if (batch)
+                {
+                    --batch->_count;
+                    return result;
+                }
                 const std::uint64_t new_ver = ++this->_version;
                 _topology->template slot<TrieResidence>()
                     .update([&](auto& header) {
                         --header._count; //number of terminals
                         header._version = new_ver; // version of trie
                     });
-                if (count) { ++*count; }
                 return result;
             }
 
@@ -1428,13 +3448,13 @@ namespace OP
             * and allows insertion (contains child node at pointed position - otherwise
             * new empty node added)
             */
-            void alter_navigation(iterator& result_iter)
+            void alter_navigation(iterator& result_iter, ResidenceDelta* batch = nullptr)
             {
                 if (!navigation_mode(result_iter))
                 {//no way down, so need create children empty node
                     const auto& back = result_iter.rat();
                     assert(back.key() < dim_t{ 256 });
-                    auto addr = new_node(result_iter.node_count());
+                    auto addr = new_node(result_iter.node_count(), batch, back.address());
                     vtm::accessor<node_t>(*_topology, back.address())
                         ->set_child(*_topology, static_cast<atom_t>(back.key()), addr);
                     result_iter.push(
@@ -1458,6 +3478,144 @@ namespace OP
                     mismatch(result_iter, begin, end);
                 return retval;
             }
+
+            /** Implementation of Batch::apply.
+            * \param operations - queued operations sorted by key
+            */
+            size_t apply_batch(const std::vector<typename Batch::Operation>& operations)
+            {
+                using kind_t = typename Batch::Kind;
+
+                WriterScope writer_g(*this);
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction());
+                ChangeCapture capture(*this, op_g);
+                ResidenceDelta delta;
+                size_t modified = 0;
+                // `cursor` keeps only complete positions (entire stem matched and child exists)
+                // of previous operation, so each of them is valid start point for navigation deep
+                iterator cursor(this);
+                for (const auto& op : operations)
+                {
+                    auto key_begin = std::begin(op._key);
+                    auto key_end = std::end(op._key);
+                    if (key_begin == key_end)
+                        continue; //empty string is not operatable
+                    const auto key_size = op._key.size();
+                    while (!cursor.is_end())
+                    {
+                        const auto& prefix = cursor.key();
+                        if (prefix.size() < key_size
+                            && std::equal(prefix.begin(), prefix.end(), key_begin))
+                            break;
+                        cursor.pop();
+                    }
+                    std::advance(key_begin, cursor.key().size());
+                    iterator result = cursor;
+                    if (op._kind == kind_t::erase)
+                    {
+                        auto found = common_prefix(key_begin, key_end, result);
+                        if (key_begin == key_end && found == StemCompareResult::equals
+                            && all_set(result.rat().terminality(), Terminality::term_has_data))
+                        {
+                            capture.add(ChangeKind::erase, result);
+                            erase_impl(result, nullptr, &delta);
+                            ++modified;
+                            cursor = iterator(this); //erase may remove nodes of the path
+                            continue;
+                        }
+                    }
+                    else
+                    {
+                        alter_navigation(result, &delta);
+                        const auto& value = *op._value;
+                        bool exists = insert_impl(result, key_begin, key_end,
+                            [&]() -> const value_type& { return value; }, &delta);
+                        if (!exists)
+                        {
+                            ++modified;
+                            capture.add(ChangeKind::insert, result);
+                        }
+                        else if (op._kind == kind_t::upsert && update_impl(result, value, &delta))
+                        {
+                            ++modified;
+                            capture.add(ChangeKind::update, result);
+                        }
+                    }
+                    cursor = std::move(result);
+                    if (!cursor.is_end())
+                    { //drop last position since it may be partially matched (so `pop` is not applicable)
+                        cursor._position_stack.pop_back();
+                        size_t prefix_length = 0;
+                        for (auto& pos : cursor._position_stack)
+                        { // each retained position leads to the child, but insert doesn't always mark it
+                            prefix_length += pos.stem_size() + 1;
+                            pos._terminality |= Terminality::term_has_child;
+                        }
+                        cursor._prefix.resize(prefix_length);
+                    }
+                }
+                if (modified)
+                {
+                    std::uint64_t filter_keys = 0;
+                    _topology->template slot<TrieResidence>()
+                        .update([&, new_ver = ++this->_version](auto& header) {
+                            header._count += delta._count;
+                            header._nodes_allocated += delta._nodes_allocated;
+                            header._version = new_ver;
+                            filter_keys = header._filter_added += delta._filter_added;
+                        });
+                    fit_filter(filter_keys);
+                }
+                capture.seal();
+                op_g.commit();
+                return modified;
+            }
+
+            /** Implementation of #find_many / #check_exists_many.
+            * \tparam FCallback - functor `void (StemCompareResult, const iterator&)` invoked once per key
+            */
+            template <class KeyRange, class FCallback>
+            void lookup_many(const KeyRange& keys, FCallback&& callback) const
+            {
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), false); //place all RO operations to atomic scope
+                // `cursor` keeps only complete positions (entire stem matched and child exists)
+                // of previous lookup, so each of them is valid start point for navigation deep
+                iterator cursor(this);
+                iterator result(this);
+                const iterator none = end();
+                for (const auto& key : keys)
+                {
+                    auto key_begin = std::begin(key);
+                    auto key_end = std::end(key);
+                    if (filter_rejects(key_begin, key_end))
+                    { //definitely absent, cursor is kept for the next key
+                        callback(StemCompareResult::no_entry, none);
+                        continue;
+                    }
+                    const auto key_size = static_cast<size_t>(std::distance(key_begin, key_end));
+                    while (!cursor.is_end())
+                    {
+                        const auto& prefix = cursor.key();
+                        if (prefix.size() < key_size
+                            && std::equal(prefix.begin(), prefix.end(), key_begin))
+                            break;
+                        cursor.pop();
+                    }
+                    std::advance(key_begin, cursor.key().size());
+                    result = cursor;
+                    StemCompareResult found = common_prefix(key_begin, key_end, result);
+                    callback(found, result);
+                    cursor = std::move(result);
+                    if (!cursor.is_end())
+                    { //drop last position since it may be partially matched (so `pop` is not applicable)
+                        cursor._position_stack.pop_back();
+                        size_t prefix_length = 0;
+                        for (const auto& pos : cursor._position_stack)
+                            prefix_length += pos.stem_size() + 1;
+                        cursor._prefix.resize(prefix_length);
+                    }
+                }
+            }
             
 
             template <class FChildLocator>
@@ -1505,8 +3663,28 @@ namespace OP
                 case StemCompareResult::unequals:
                 {
                     if (!prefix.is_end())
-                    {
-                        _next(prefix);
+                    { //stem of the last position is matched partially, so restore entire entry first
+                        const auto matched = prefix.key().size();
+                        const atom_t query_atom = *begin;
+                        auto [ok, child] = load_iterator(
+                            prefix.rat().address(), prefix,
+                            [&](vtm::ReadonlyAccess<node_t>&) {
+                                return NullableAtom{ prefix.rat().key() };
+                            },
+                            &iterator::update_back);
+                        assert(ok); //entry has been just matched
+                        if (query_atom < prefix.key()[matched])
+                        { //entire subtree of entry is bigger than query, so start from the entry
+                            if (is_not_set(prefix.rat().terminality(), Terminality::term_has_data))
+                            {
+                                enter_deep_until_terminal(child, prefix,
+                                    [](vtm::ReadonlyAccess<node_t>& ro_node) {
+                                        return ro_node->first();
+                                    });
+                            }
+                        }
+                        else //entire subtree of entry is less than query
+                            _next(prefix, false);
                     }
                     return false; //not an exact match
                 }
@@ -1530,7 +3708,7 @@ namespace OP
 
                     if (is_not_set(prefix.rat().terminality(), Terminality::term_has_data))
                     {
-                        enter_deep_until_terminal(back.address(), prefix,
+                        enter_deep_until_terminal(child, prefix,
                             [](vtm::ReadonlyAccess<node_t>& ro_node) { return ro_node->first(); });
                     }
                     return false; //not an exact match
@@ -1614,6 +3792,12 @@ namespace OP
                 return true;
             }
 
+            /** Hint segment manager that node at `node_addr` is going to be read soon, nil address is ignored */
+            void prefetch_node(FarAddress node_addr) const noexcept
+            {
+                _topology->segment_manager().prefetch(node_addr, static_cast<vtm::segment_pos_t>(sizeof(node_t)));
+            }
+
             /**
             * \tparam FFindEntry - function `NullableAtom (ReadonlyAccess<node_t>&)` 
             *           that resolve index inside node;
@@ -1641,6 +3825,7 @@ namespace OP
                 );
                 return ro_node->rawc(*_topology, pos.value(),
                     [&](const auto& node_data) {
+                        prefetch_node(node_data._child); //let child load while stem is copied
                         if (!node_data._stem.is_nil())
                         {//if stem exists should be placed to iterator
                             vtm::StringMemoryManager smm(*_topology);
@@ -1664,6 +3849,52 @@ namespace OP
 
             }
 
+            /** Range over entries with keys in `[from, to)`, absent `to` means the end of trie */
+            auto interval_range(key_t from, std::optional<key_t> to) const
+            {
+                return make_mixed_sequence_factory(
+                    this->shared_from_this(),
+                    Ingredient::KeyInterval<key_t>(std::move(from), std::move(to)));
+            }
+
+            template <class TThreads, class F>
+            auto start_partitions(TThreads& pool, size_t fanout, F f) const
+            {
+                using partition_t = decltype(interval_range(key_t{}, std::optional<key_t>{}));
+                using result_t = std::invoke_result_t<F&, const partition_t&>;
+                static_assert(!std::is_void_v<result_t>, "partition functor must return a value");
+
+                std::vector<std::future<result_t>> result;
+                for (auto& partition : partitions(fanout))
+                {
+                    result.emplace_back(pool.async(
+                        [f, partition = std::move(partition)]() mutable -> result_t {
+                            return f(std::as_const(partition));
+                        }));
+                }
+                return result;
+            }
+
+            /**
+            *   Copy sequence of entries started at `start()` while `in_range` is true.
+            * \tparam FStart - functor `iterator ()` to resolve first entry;
+            * \tparam FInRange - predicate `bool (const iterator&)`
+            */
+            template <class FStart, class FInRange>
+            snapshot_t make_snapshot(FStart start, FInRange in_range) const
+            {
+                //writers wait until copy completes, so entries reflect exactly one version
+                std::unique_lock<std::shared_mutex> writers_g(_writers_lock, std::defer_lock);
+                if (!WriterScope::held_by_this_thread(*this))
+                    writers_g.lock();
+                OP::vtm::TransactionGuard op_g(_topology->segment_manager().begin_transaction(), true);
+                const auto pinned = _version.load();
+                typename snapshot_t::entries_t entries;
+                for (auto i = start(); !i.is_end() && in_range(i); _next(i))
+                    entries.emplace_back(i.key(), i.value());
+                return snapshot_t(static_cast<node_version_t>(pinned), std::move(entries));
+            }
+
             void _next(iterator& i, bool way_down = true) const
             {
                 while (!i.is_end())
@@ -1705,6 +3936,52 @@ namespace OP
                 }
             }
 
+            /** Backward navigation, mirrors #_next: entry with children is always less than any of its
+            *   children, so previous position is either the deepest last entry of left sibling or the parent.
+            */
+            void _prev(iterator& i) const
+            {
+                while (!i.is_end())
+                {
+                    //try navigate left from current position
+                    auto [ok, child] = load_iterator(i.rat().address(), i,
+                        [&i](vtm::ReadonlyAccess<node_t>& ro_node)
+                        {
+                            //don't optimize `i.rat` since i may change
+                            return ro_node->prev((atom_t)i.rat().key());
+                        },
+                        &iterator::update_back);
+                    if (ok)
+                    { //navigation left succeeded
+                        if (all_set(i.rat().terminality(), Terminality::term_has_child))
+                        {
+                            enter_deep_until_last(child, i);
+                        }
+                        return;
+                    }
+                    //no way left, so parent is the previous if it has a value
+                    i.pop();
+                    if (!i.is_end() && all_set(i.rat().terminality(), Terminality::term_has_data))
+                        return;
+                }
+            }
+
+            /** Enters deep to child hierarchy by the last entries until entry without children found.
+            *   Such entry is the biggest in the sub-tree.
+            */
+            void enter_deep_until_last(FarAddress start_from, iterator& i) const
+            {
+                bool ok = true;
+                do
+                {
+                    assert(!start_from.is_nil());
+                    std::tie(ok, start_from) = load_iterator(start_from, i,
+                        [](vtm::ReadonlyAccess<node_t>& ro_node) { return ro_node->last(); },
+                        &iterator::emplace);
+                    assert(ok); //empty nodes are not allowed
+                } while (all_set(i.rat().terminality(), Terminality::term_has_child));
+            }
+
             /** Enters deep to child hierarchy until first terminal entry found
             \tparam FChildLocator - lambda to locate first meaningful position inside child
                 signature must match `void (ReadonlyAccess<node_t>& )`
@@ -1,6 +1,7 @@
 #ifndef _OP_TRIE_TRIEITERATOR__H_
 #define _OP_TRIE_TRIEITERATOR__H_
 
+#include <op/common/InlineVector.h>
 #include <op/trie/TrieNode.h>
 #include <op/trie/TriePosition.h>
 
@@ -10,7 +11,16 @@
 namespace OP::trie
 {
 
-    template <class Container>
+    /**
+    *   Bidirectional iterator over Trie entries.
+    *   Iterator keeps stack of positions from the root to the current entry. Stack is stored inline
+    *   (without heap allocation) while depth of the entry doesn't exceed `inline_depth_c`, so
+    *   scan and copy of iterator (for example by flur pipelines) doesn't involve the heap for typical keys.
+    *
+    *   \tparam Container - owning trie;
+    *   \tparam inline_depth_c - number of positions kept inside iterator before fall back to the heap.
+    */
+    template <class Container, size_t inline_depth_c = 8>
     class TrieIterator
     {
     public:
@@ -23,7 +33,7 @@ namespace OP::trie
         using key_type = prefix_string_t;
         using key_t = prefix_string_t;
         using value_type = typename Container::value_type;
-        using this_t = TrieIterator<Container>;
+        using this_t = TrieIterator<Container, inline_depth_c>;
 
         using atom_t = OP::common::atom_t;
         using dim_t = OP::vtm::dim_t;
@@ -32,7 +42,7 @@ namespace OP::trie
         friend Container;
         friend typename Container::node_t;
 
-        using node_stack_t = std::vector<TriePosition>;
+        using node_stack_t = OP::InlineVector<TriePosition, inline_depth_c>;
         node_stack_t _position_stack;
         const Container* _container = nullptr;
         prefix_string_t _prefix;
@@ -69,14 +79,14 @@ namespace OP::trie
 
         inline this_t& operator -- ()
         {
-            assert(false);//, "Not implemented yet");
+            _container->prev(*this);
             return *this;
         }
 
         inline this_t operator -- (int)
         {
-            assert(false);//, "Not implemented yet");
             this_t result(*this);
+            _container->prev(*this);
             return result;
         }
 
@@ -5,9 +5,11 @@
 #include <op/common/StackAlloc.h>
 
 #include <op/vtm/SegmentManager.h>
+#include <op/vtm/MemoryChunks.h>
 
 #include <op/trie/HashTable.h>
 #include <op/trie/AntiHashTable.h>
+#include <op/trie/DenseTable.h>
 #include <op/trie/TriePosition.h>
 #include <op/vtm/PersistedReference.h>
 #include <op/vtm/StringMemoryManager.h>
@@ -17,12 +19,23 @@ namespace OP
     namespace trie
     {
 
-        /** Represent single node of Trie*/
-        template <class PayloadManager>
+        namespace details
+        {
+            /** Placeholder of subtree counter for nodes without counters, occupies tail padding of the node */
+            struct NoSubtreeCount
+            {
+            };
+        }//ns:details
+
+        /** Represent single node of Trie
+        * \tparam subtree_counters_c - when true node keeps number of values of its subtree
+        *   (\sa TrieFeature::subtree_counters)
+        */
+        template <class PayloadManager, bool subtree_counters_c = false>
         struct TrieNode
         {
             using payload_manager_t = PayloadManager;
-            using this_t = TrieNode<payload_manager_t>;
+            using this_t = TrieNode<payload_manager_t, subtree_counters_c>;
             using atom_t = OP::common::atom_t;
             using NullableAtom = OP::vtm::NullableAtom;
             using dim_t = OP::vtm::dim_t;
@@ -55,13 +68,43 @@ namespace OP
             FarAddress _hash_table;
             /** Capacity of allocated KeyValueContainer */
             dim_t _capacity;
+            /** Number of values stored by this node and all its descendants, exists only if `subtree_counters_c` */
+            std::conditional_t<subtree_counters_c, std::uint64_t, details::NoSubtreeCount> _subtree_count;
 
             TrieNode(dim_t capacity) noexcept
                 : _version(0)
                 , _capacity(capacity)
+                , _subtree_count{}
+            {
+                //capacity must be one of dense layouts or pow of 2 and lay in range [8-256]
+                assert(containers::details::is_dense(_capacity)
+                    ? containers::details::fit_capacity(capacity_slots()) == _capacity
+                    : (_capacity >= 8 && _capacity <= 256 && ((_capacity - 1) & _capacity) == 0));
+            }
+
+            /** \return number of values in subtree of this node, always 0 if node doesn't keep counters */
+            std::uint64_t subtree_count() const noexcept
             {
-                //capacity must be pow of 2 and lay in range [8-256]
-                assert(_capacity >= 8 && _capacity <= 256 && ((_capacity - 1) & _capacity) == 0);
+                if constexpr (subtree_counters_c)
+                    return _subtree_count;
+                else
+                    return 0;
+            }
+
+            void add_subtree_count(std::int64_t delta) noexcept
+            {
+                if constexpr (subtree_counters_c)
+                    _subtree_count += delta;
+            }
+
+            /** \return subtree counter of node at `node` address without reading the node if counters are off */
+            template <class TTopology>
+            static std::uint64_t subtree_count_of(TTopology& topology, FarAddress node)
+            {
+                if constexpr (subtree_counters_c)
+                    return vtm::view<this_t>(topology, node)->_subtree_count;
+                else
+                    return 0;
             }
 
             template <class TTopology>
@@ -118,6 +161,54 @@ namespace OP
                 ++_version;
             }
 
+            /**
+            *   Place brand new entry with all attributes (stem, child reference and optional value) known
+            *   in advance, so container is probed only once. Used by bulk construction of trie.
+            * \param stem - already allocated stem string (\sa vtm::StringMemoryManager::smart_insert) or
+            *   empty address. The same stem may be shared by several entries of read-only trie.
+            * \param child - address of child node or nil if entry has no children
+            * \param has_value - when false `payload_factory` is never invoked
+            * \tparam FProducePayload - functor `void (payload_t&)` to assign value
+            */
+            template <class TSegmentTopology, class FProducePayload>
+            void place(TSegmentTopology& topology, atom_t key,
+                stem_str_address_t stem, FarAddress child, bool has_value,
+                FProducePayload&& payload_factory)
+            {
+                assert(!presence(key));
+                for (;;)
+                {
+                    wrap_key_value_t container;
+                    kv_container(topology, container); //resolve correct instance implemented by this node
+
+                    auto [hash, success] = container->insert(key,
+                        [&](NodeData& to_construct) {
+                            ::new (&to_construct)NodeData;
+                            if (has_value)
+                            {
+                                payload_manager_t::allocate(topology, to_construct._value);
+                                payload_manager_t::raw(topology, to_construct._value, payload_factory);
+                                _value_presence.set(key);
+                            }
+                            if (!child.is_nil())
+                            {
+                                to_construct._child = child;
+                                _child_presence.set(key);
+                            }
+                            to_construct._stem = stem;
+                        });
+
+                    if (success)
+                        break;
+
+                    assert(hash == vtm::dim_nil_c);//only possible reason to be there - capacity is over
+                    grow(topology, *container);
+                }
+                add_subtree_count((has_value ? 1 : 0)
+                    + (child.is_nil() ? 0 : subtree_count_of(topology, child)));
+                ++_version;
+            }
+
             /**
             * @return true if entire node should be deleted
             */
@@ -174,6 +265,8 @@ namespace OP
                 kv_container(topology, container); //resolve correct instance implemented by this node
                 vtm::StringMemoryManager string_memory_manager(topology);
 
+                //presence bits are kept untouched during iteration since some containers
+                //(DenseTable) use them to locate entry
                 for (auto i = presence_first_set(); vtm::dim_nil_c != i;
                     i = presence_next_set(static_cast<atom_t>(i)))
                 {
@@ -182,7 +275,6 @@ namespace OP
                     if (_value_presence.get(i))
                     {//wipe-out data
                         payload_manager_t::destroy(topology, node->_value);
-                        _value_presence.clear(i);
                         ++data_slots;
                     }
                     if (!node->_stem.is_nil())
@@ -194,9 +286,46 @@ namespace OP
                     {//wipe children
                         assert(!node->_child.is_nil());
                         child_process.push(node->_child);
-                        _child_presence.clear(i);
                     }
                 }
+                _value_presence = presence_t{};
+                _child_presence = presence_t{};
+                return data_slots;
+            }
+
+            /**
+            *   The same as #erase_all but for the single entry `key`: frees value and stem and gives a caller
+            *   address of child node (if any) to destroy without recursion. Entry is removed from the node.
+            *   @return number of data-slots destroyed (0 or 1)
+            */
+            template <class TSegmentTopology>
+            size_t erase_entry(TSegmentTopology& topology, atom_t key, std::stack<FarAddress>& child_process)
+            {
+                ++_version;
+                wrap_key_value_t container;
+                kv_container(topology, container); //resolve correct instance implemented by this node
+                NodeData* node = container->get(key);
+                assert(node);
+                size_t data_slots = 0;
+                if (_value_presence.get(key))
+                {
+                    payload_manager_t::destroy(topology, node->_value);
+                    ++data_slots;
+                }
+                if (!node->_stem.is_nil())
+                {
+                    vtm::StringMemoryManager string_memory_manager(topology);
+                    string_memory_manager.destroy(node->_stem);
+                }
+                if (_child_presence.get(key))
+                {
+                    assert(!node->_child.is_nil());
+                    child_process.push(node->_child);
+                }
+                container->erase(key);
+                //presence must be cleared after `container->erase`
+                _value_presence.clear(key);
+                _child_presence.clear(key);
                 return data_slots;
             }
 
@@ -342,6 +471,12 @@ namespace OP
                 return NullableAtom{ this->presence_next_set_or_this(previous) };
             }
 
+            /**@return previous position where child or value exists, may return dim_nil_c if no more entries*/
+            NullableAtom prev(atom_t following) const noexcept
+            {
+                return NullableAtom{ this->presence_prev_set(following) };
+            }
+
             /**
             * Move entry from this specified by 'key' node that is started on 'in_stem_pos' to another one
             * specified by 'target' address
@@ -404,6 +539,10 @@ namespace OP
                         }
 
                         //copy data/address to target
+                        target_node->add_subtree_count((_value_presence.get(source_key) ? 1 : 0)
+                            + (_child_presence.get(source_key)
+                                ? subtree_count_of(topology, source._child)
+                                : 0));
                         target_data._child = source._child;
                         target_node->_child_presence.assign(new_key, _child_presence.get(source_key));
                         source._child = target_node.address();
@@ -436,9 +575,10 @@ namespace OP
                 kv_container(topology, src_container); //resolve correct instance implemented by this node
                 return src_container->reindex(_hash_table, _capacity, key);
             }
+            /** \return max number of entries that can be stored without grow */
             dim_t capacity() const
             {
-                return _capacity;
+                return capacity_slots();
             }
             FarAddress reindex_table() const
             {
@@ -448,63 +588,70 @@ namespace OP
             {
                 return _child_presence.get(key) || _value_presence.get(key);
             }
+            /** \return union of child and value presence, so each set bit indicates existing entry */
+            inline presence_t presence_union() const noexcept
+            {
+                return _child_presence | _value_presence;
+            }
             inline dim_t presence_first_set() const
             {
-                dim_t ch_res = _child_presence.first_set();
-                dim_t dt_res = _value_presence.first_set();
-                if (vtm::dim_nil_c == ch_res)
-                    return dt_res;
-                if (vtm::dim_nil_c == dt_res)
-                    return ch_res;
-                return std::min(dt_res, ch_res);
+                return presence_union().first_set();
             }
             /**@return last position where child or value exists, may return dim_nil_c if node empty*/
             inline dim_t presence_last_set() const
             {
-                dim_t ch_res = _child_presence.last_set();
-                dim_t dt_res = _value_presence.last_set();
-                if (vtm::dim_nil_c == ch_res)
-                    return dt_res;
-                if (vtm::dim_nil_c == dt_res)
-                    return ch_res;
-                return std::max(dt_res, ch_res);
+                return presence_union().last_set();
             }
 
             /**@return next position where child or value exists, may return dim_nil_c if no more entries*/
             inline dim_t presence_next_set(atom_t previous) const
             {
-                dim_t ch_res = _child_presence.next_set(previous);
-                dim_t dt_res = _value_presence.next_set(previous);
-                if (vtm::dim_nil_c == ch_res)
-                    return dt_res;
-                if (vtm::dim_nil_c == dt_res)
-                    return ch_res;
-                return std::min(dt_res, ch_res);
+                return presence_union().next_set(previous);
+            }
+            /**@return highest position below `following` where child or value exists, may return dim_nil_c if no such entries*/
+            inline dim_t presence_prev_set(atom_t following) const
+            {
+                return presence_union().prev_set(following);
             }
             /**@return next or the same position where child or value exists, may return dim_nil_c if no more entries*/
             inline dim_t presence_next_set_or_this(atom_t previous) const
             {
-                dim_t ch_res = _child_presence.next_set_or_this(previous);
-                dim_t dt_res = _value_presence.next_set_or_this(previous);
-                if (vtm::dim_nil_c == ch_res)
-                    return dt_res;
-                if (vtm::dim_nil_c == dt_res)
-                    return ch_res;
-                return std::min(dt_res, ch_res);
+                return presence_union().next_set_or_this(previous);
+            }
+            /**@return dense (zero based) ordinal of the `key` among all entries of this node. For absent 
+            *   `key` it is number of entries that are less than `key`
+            */
+            inline dim_t presence_rank(atom_t key) const
+            {
+                return presence_union().rank(key);
+            }
+            /**@return key of the entry that has dense ordinal `nth`, may return dim_nil_c if no such entry*/
+            inline dim_t presence_select(dim_t nth) const
+            {
+                return presence_union().select(nth);
             }
 
 
         private:
             using hash_table_t = containers::PersistedHashTable< NodeData, this_t >;
             using anti_hash_table_t = containers::AntiHashTable< NodeData, this_t>;
+            using dense_table_t = containers::DenseTable< NodeData, this_t>;
+
+            using wrap_key_value_t = Multiimplementation<key_value_t, hash_table_t, anti_hash_table_t, dense_table_t>;
 
-            using wrap_key_value_t = Multiimplementation<key_value_t, hash_table_t, anti_hash_table_t>;
+            dim_t capacity_slots() const noexcept
+            {
+                return containers::details::slots(_capacity);
+            }
 
             template <class TSegmentTopology>
             auto kv_container(TSegmentTopology& topology, wrap_key_value_t& out, dim_t capacity = vtm::dim_nil_c) const
             {
                 if (capacity == vtm::dim_nil_c)
                     capacity = _capacity;
+                if (containers::details::is_dense(capacity))
+                    return static_cast<key_value_t*>(
+                        &out.template construct<dense_table_t>(topology, *this, capacity));
                 return (capacity < 256)
                     ? static_cast<key_value_t*>(
                         &out.template construct<hash_table_t>(topology, *this, capacity))
@@ -543,9 +690,9 @@ namespace OP
             {
                 dim_t new_capacity;
                 for (
-                    new_capacity = OP::trie::containers::details::grow_size(_capacity);
+                    new_capacity = OP::trie::containers::details::node_grow_size(_capacity);
                     true;
-                    new_capacity = OP::trie::containers::details::grow_size(new_capacity))
+                    new_capacity = OP::trie::containers::details::node_grow_size(new_capacity))
                 {
                     wrap_key_value_t new_container;
 
@@ -7,6 +7,32 @@ namespace OP
 {
     namespace trie
     {
+        /**
+        *   Optional features of Trie that change persisted layout. Set of features the storage was created
+        *   with is kept in TrieResidence::TrieHeader, so storage can be opened only by Trie with the same set.
+        */
+        enum class TrieFeature : std::uint32_t
+        {
+            none = 0,
+            /** Each node keeps number of values in its subtree, enables Trie::count_prefix, Trie::rank,
+            *   Trie::select and Trie::count_range at the cost of updating all nodes on the path of each
+            *   insert and erase */
+            subtree_counters = 0x1,
+            /** Keys are added to MembershipFilter, so most of absent keys are rejected by Trie::find and
+            *   Trie::check_exists without navigation at the cost of one more block written by each insert */
+            membership_filter = 0x2
+        };
+
+        constexpr inline TrieFeature operator | (TrieFeature left, TrieFeature right) noexcept
+        {
+            return static_cast<TrieFeature>(static_cast<std::uint32_t>(left) | static_cast<std::uint32_t>(right));
+        }
+
+        constexpr inline bool has_feature(TrieFeature set, TrieFeature test) noexcept
+        {
+            return (static_cast<std::uint32_t>(set) & static_cast<std::uint32_t>(test)) == static_cast<std::uint32_t>(test);
+        }
+
         /**
         *   Small slot to keep arbitrary Trie information in 0 segment
         */
@@ -24,6 +50,10 @@ namespace OP
                     , _count(0)
                     , _nodes_allocated(0)
                     , _version(0)
+                    , _minimized(0)
+                    , _format(format_c)
+                    , _features(0)
+                    , _filter_added(0)
                 {}
                 /**Where root resides*/
                 FarAddress _root;
@@ -33,9 +63,22 @@ namespace OP
                 std::uint64_t _nodes_allocated;
                 /** Total version of trie */
                 std::uint64_t _version;
+                /** Not 0 when nodes are shared between identical subtrees, so trie must not be modified */
+                std::uint64_t _minimized;
+                /** Always #format_c for storage of the current layout. Storage created before the format
+                *   has been introduced keeps there bytes of the following slot */
+                std::uint32_t _format;
+                /** Set of TrieFeature the storage was created with */
+                std::uint32_t _features;
+                /** Number of keys added to MembershipFilter since it was populated, includes keys that
+                *   were erased later. Kept here, so insert modifies the header once for both counters */
+                std::uint64_t _filter_added;
             };
 
-            template <class TSegmentManager, class Payload, class TKeyString, std::uint32_t initial_node_count>
+            /** Signature 'Tr' in high half and version of persisted layout in low half */
+            constexpr static std::uint32_t format_c = 0x54720003;
+
+            template <class TSegmentManager, class Payload, class TKeyString, std::uint32_t initial_node_count, TrieFeature features>
             friend struct Trie;
         
             explicit TrieResidence(vtm::SegmentManager& manager) noexcept
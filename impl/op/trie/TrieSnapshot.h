@@ -0,0 +1,119 @@
+#pragma once
+
+#ifndef _OP_TRIE_TRIESNAPSHOT__H_
+#define _OP_TRIE_TRIESNAPSHOT__H_
+
+#include <vector>
+#include <algorithm>
+
+#include <op/flur/flur.h>
+#include <op/trie/TriePosition.h>
+
+namespace OP::trie
+{
+    /**
+    *   Immutable read view of the Trie pinned to a single version (\sa Trie::snapshot).
+    * Content is copied out of persisted storage at the moment of creation, so iteration
+    * over snapshot never re-syncs, doesn't open transactions and isn't affected by writers
+    * that continue to modify the origin trie.
+    *
+    * \tparam Key - string-like type of key (the same as Trie::key_t);
+    * \tparam Value - type of value (the same as Trie::value_type).
+    */
+    template <class Key, class Value>
+    class TrieSnapshot
+    {
+    public:
+        using key_t = Key;
+        using value_type = Value;
+        using entry_t = std::pair<key_t, value_type>;
+        using entries_t = std::vector<entry_t>;
+        using const_iterator = typename entries_t::const_iterator;
+
+        /**
+        * \param version - version of trie the `entries` were taken at;
+        * \param entries - lexicographically ordered sequence of key-value pairs.
+        */
+        TrieSnapshot(node_version_t version, entries_t entries) noexcept
+            : _version(version)
+            , _entries(std::move(entries))
+        {
+        }
+
+        /** Version of trie this snapshot is pinned to */
+        node_version_t version() const noexcept
+        {
+            return _version;
+        }
+
+        size_t size() const noexcept
+        {
+            return _entries.size();
+        }
+
+        bool empty() const noexcept
+        {
+            return _entries.empty();
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return _entries.cbegin();
+        }
+
+        const_iterator end() const noexcept
+        {
+            return _entries.cend();
+        }
+
+        /** \return first entry that is not less than `key` or #end() */
+        template <class AtomString>
+        const_iterator lower_bound(const AtomString& key) const
+        {
+            return std::lower_bound(begin(), end(), key,
+                [](const entry_t& entry, const AtomString& k) {
+                    return std::lexicographical_compare(
+                        std::begin(entry.first), std::end(entry.first), std::begin(k), std::end(k));
+                });
+        }
+
+        /** \return entry exactly matching `key` or #end() */
+        template <class AtomString>
+        const_iterator find(const AtomString& key) const
+        {
+            auto found = lower_bound(key);
+            if (found != end() && std::equal(
+                std::begin(found->first), std::end(found->first), std::begin(key), std::end(key)))
+                return found;
+            return end();
+        }
+
+        /** LazyRange over all entries. Range refers to this snapshot so it must outlive the range */
+        auto range() const
+        {
+            return OP::flur::src::of_iterators(begin(), end());
+        }
+
+        /** LazyRange over entries that start with `prefix`. Range refers to this snapshot so it
+        *   must outlive the range
+        */
+        template <class AtomString>
+        auto prefixed_range(const AtomString& prefix) const
+        {
+            auto from = lower_bound(prefix);
+            //all entries with the same prefix are adjacent
+            auto to = std::partition_point(from, end(), [&](const entry_t& entry) {
+                return entry.first.size() >= std::size(prefix) &&
+                    std::equal(std::begin(prefix), std::end(prefix), std::begin(entry.first));
+                });
+            return OP::flur::src::of_iterators(from, to);
+        }
+
+    private:
+        node_version_t _version;
+        entries_t _entries;
+    };
+
+}//ns:OP::trie
+
+#endif //_OP_TRIE_TRIESNAPSHOT__H_
@@ -175,6 +175,12 @@ namespace OP::vtm
             return this->_segment_size;
         }
 
+        /** Biggest `byte_count` accepted by #allocate, since single block cannot span several segments */
+        constexpr segment_pos_t max_allocation_size() const noexcept
+        {
+            return this->_segment_size - OP::utils::aligned_sizeof<LogEntry>(SegmentDef::align_c);
+        }
+
         segment_idx_t segments_count() const
         {
             guard_t guard_header(_header_lock);
@@ -216,6 +222,21 @@ namespace OP::vtm
          */
         template <class TCallback>
         void for_each(TCallback&& f)
+        {
+            for_each_from(FarAddress{}, std::forward<TCallback>(f));
+        }
+
+        /**
+         * Same as #for_each but starts iteration from the block allocated at `from`. Allows to resume
+         * iteration later (for example to tail the log while it grows) without visiting already processed blocks.
+         *
+         * \param from Address of the block to start from (as returned by #allocate or by previous call of 
+         *              this method). Nil address means the first block of the log.
+         * \return Address to resume iteration from: either the block where callback returned `false` 
+         *              (this block is treated as not processed) or the end of the log.
+         */
+        template <class TCallback>
+        FarAddress for_each_from(FarAddress from, TCallback&& f)
         {
             using ftraits_t = OP::utils::function_traits<TCallback>;
             using arg0_t = typename ftraits_t::template arg_i<0>;
@@ -225,7 +246,7 @@ namespace OP::vtm
             auto header = _at_impl<Header>(FarAddress(0));
             //as soon A0l only grows, _end item can be cached and then checked with double-check pattern
             auto check_last = header->_end;
-            auto i = header->_first;
+            auto i = from.is_nil() ? header->_first : from;
             auto current_segment = i.segment();
             bip::mapped_region* current_mapping = &ensure_segment(current_segment);
             top_lock.unlock();
@@ -258,6 +279,7 @@ namespace OP::vtm
                     current_mapping = &ensure_segment(current_segment);
                 }
             }
+            return i;
         }
 
         /**
@@ -265,6 +287,7 @@ namespace OP::vtm
          *
          * \param byte_count Number of bytes to allocate. The method will align this value
          *        up to `SegmentDef::align_c`.
+         *        Must not exceed #max_allocation_size.
          *
          * \return A `std::pair<FarAddress, std::uint8_t*>` where:
          *         - The first element is a `FarAddress` that can be persisted and later
@@ -97,6 +97,17 @@ namespace OP::vtm
             /** Ensure underlying storage is synchronized */
             virtual void flush() = 0;
 
+            /**
+            *  \brief Hint that block will be read soon.
+            *
+            *  Lets implementation start loading memory (e.g. issue CPU prefetch for mapped pages) while the 
+            *  caller is busy with the previous block. Method never changes state, never locks and never throws, 
+            *  so it is safe to pass address that may be invalid. Default implementation does nothing.
+            */
+            virtual void prefetch(FarAddress /*pos*/, segment_pos_t /*size*/) noexcept
+            {
+            }
+
             /** \brief Get strong typed access to memory for read-only purposes.
             *   The method just wrap #readonly_block with typed access
             */
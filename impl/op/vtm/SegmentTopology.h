@@ -196,7 +196,8 @@ namespace OP::vtm
                 ReadonlyMemoryChunk topology_address = manager.readonly_block(
                     FarAddress(opening_segment, current_offset), processing_size);
                 const TopologyHeader* header = topology_address.at<TopologyHeader>(0);
-                assert(header->_slots_count == slots_count_c);
+                if (header->_slots_count != slots_count_c) //segment has been created by another topology
+                    throw OP::Exception(vtm::ErrorCodes::er_invalid_signature);
                  
                 std::apply([&](auto& ...slot_ptr)->void{
                     size_t i = 0;
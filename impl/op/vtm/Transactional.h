@@ -10,6 +10,7 @@
 #include <typeinfo>
 #include <cassert>
 #include <thread>
+#include <functional>
 
 #include <op/common/EventSupplier.h>
 #include <op/common/Assoc.h>
@@ -72,8 +73,19 @@ namespace OP::vtm
             return _transaction_id;
         }
 
+        /** Handler invoked once changes of transaction become visible to others */
+        using commit_handler_t = std::function<void()>;
+
         virtual std::shared_ptr<Transaction> recurrent() = 0;
 
+        /**
+        *   Register `handler` to be invoked at commit of the outermost transaction. Nested transaction
+        *   passes its handlers to the enclosing one on commit, rollback drops them. Handlers are invoked
+        *   in order of registration while modified blocks are still locked, so handlers of concurrent
+        *   transactions touching the same block run in order of commit. Handler must not throw.
+        */
+        virtual void on_commit(commit_handler_t handler) = 0;
+
         virtual void rollback() = 0;
         virtual void commit() = 0;
         virtual std::shared_ptr<Transaction> merge_thread() = 0;
@@ -131,6 +143,12 @@ namespace OP::vtm
             return shared_from_this();
         }
 
+        /** No-op transaction cannot retract changes, so handler is invoked immediately */
+        virtual void on_commit(commit_handler_t handler) override
+        {
+            handler();
+        }
+
         virtual void rollback() override
         {
             //invoke events on transaction end
@@ -289,7 +307,7 @@ namespace OP::vtm
     {
         static_assert(N > 0, "set number of retries greater than zero");
         constexpr size_t limit = N - 1;
-        for (auto i = 0; i < limit; ++i)
+        for (size_t i = 0; i < limit; ++i)
         {
             try
             {
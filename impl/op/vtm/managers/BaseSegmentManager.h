@@ -269,6 +269,19 @@ namespace OP::vtm
                     size, pos);
             }
 
+            /**
+            *  \brief Issue CPU prefetch for the mapped memory of the block.
+            *  Nil address or address of segment that is not mapped yet is ignored, so the method
+            *  never causes new mapping.
+            */
+            virtual void prefetch(FarAddress pos, segment_pos_t size) noexcept override
+            {
+                if (pos.is_nil())
+                    return;
+                if (const auto* region = _cached_segments.find(pos.segment()); region)
+                    region->prefetch(pos.offset(), size);
+            }
+
             /**
             *  \brief Get memory for write purposes.
             * \throws ConcurrentLockException if block is already locked by another transaction.
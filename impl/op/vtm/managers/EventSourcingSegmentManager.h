@@ -6,6 +6,7 @@
 #include <shared_mutex>
 #include <queue>
 #include <variant>
+#include <vector>
 
 #include <op/common/Exceptions.h>
 #include <op/common/Unsigned.h>
@@ -229,6 +230,12 @@ namespace OP::vtm
         }
 
 
+        /** Prefetch is forwarded to the base manager, shadow buffers are built from the same memory */
+        void prefetch(FarAddress pos, segment_pos_t size) noexcept override
+        {
+            _base_manager->prefetch(pos, size);
+        }
+
         [[nodiscard]] MemoryChunk writable_block(
             FarAddress pos, segment_pos_t size, WritableBlockHint hint = WritableBlockHint::update_c)  override
         {
@@ -359,6 +366,12 @@ namespace OP::vtm
                 _framed_tx->unmerge_thread();
             }
 
+            virtual void on_commit(commit_handler_t handler) override
+            {
+                throw_if_write_disallowed();
+                _commit_handlers.emplace_back(std::move(handler));
+            }
+
             TransactionState state() const
             {
                 return _tr_state;
@@ -368,6 +381,7 @@ namespace OP::vtm
             /**After commit/rollback transaction must not be used anymore*/
             TransactionState _tr_state = TransactionState::active;
             TransactionImpl* _framed_tx = nullptr;
+            std::vector<commit_handler_t> _commit_handlers;
         };
 
 
@@ -397,7 +411,11 @@ namespace OP::vtm
                 if(_tr_state >= TransactionState::sealed_rollback_only)
                     throw Exception(OP::vtm::ErrorCodes::er_transaction_ghost_state);
                 // No real commit for WR
+                auto handlers = std::move(_commit_handlers);
                 close(); 
+                // after close enclosing save-point (or the framed transaction) is active again
+                for (auto& handler : handlers)
+                    _framed_tx->on_commit(std::move(handler));
             }
 
             void rollback() override
@@ -412,6 +430,7 @@ namespace OP::vtm
                     );
                 }
                 _transaction_log.clear();
+                _commit_handlers.clear();
                 close();
             }
         private:
@@ -503,6 +522,15 @@ namespace OP::vtm
                 // implementation doesn't need explictly store record, it is managed by MemoryChangeHistory
             }
 
+            virtual void on_commit(commit_handler_t handler) override
+            {
+                throw_if_write_disallowed();
+                if (_active_save_point)
+                    _active_save_point->on_commit(std::move(handler));
+                else
+                    _commit_handlers.emplace_back(std::move(handler));
+            }
+
             void rollback() override
             {
                 throw_if_write_disallowed();
@@ -510,6 +538,7 @@ namespace OP::vtm
                     throw OP::Exception(vtm::ErrorCodes::er_cannot_close_transaction_while_merged_thread);
                 //invoke events on transaction end
                 _owner._transaction_event_supplier.send<TransactionEvent::before_rollback>(transaction_id());
+                _commit_handlers.clear();
                 next_state(_tr_state); //disable accept changes in this
                 _owner._transaction_event_supplier.send<TransactionEvent::rolledback>(transaction_id());
                 _owner.dispose_transaction(*this);
@@ -531,6 +560,10 @@ namespace OP::vtm
                         wr_access.byte_copy(source.get(), source.size());
                         return true; //continue iteration
                     }, &_owner);
+                // locks are released by `committed` event, so handlers of concurrent transactions keep commit order
+                for (auto& handler : _commit_handlers)
+                    handler();
+                _commit_handlers.clear();
                 next_state(_tr_state); //disable accept changes in this
                 _owner._transaction_event_supplier.send<TransactionEvent::committed>(transaction_id());
                 _owner.dispose_transaction(*this);
@@ -4,6 +4,7 @@
 #define _OP_VTM_SEGMENTREGION__H_
 
 #include <cassert>
+#include <algorithm>
 
 #include <boost/interprocess/file_mapping.hpp>
 #include <boost/interprocess/mapped_region.hpp>
@@ -96,6 +97,21 @@ namespace OP::vtm
             return reinterpret_cast<std::uint8_t*>(this->_mapped_region.get_address()) + offset;
         }
 
+        /**
+        *   Issue software prefetch for cache lines of the range [offset, offset+size). Range is
+        *   silently truncated by the region size, so it is safe to pass a speculative address.
+        */
+        void prefetch(segment_pos_t offset, segment_pos_t size) const noexcept
+        {
+            const auto region_size = _mapped_region.get_size();
+            if (offset >= region_size)
+                return;
+            const auto end = std::min<std::size_t>(region_size, std::size_t{ offset } + size);
+            const auto* base = reinterpret_cast<const std::uint8_t*>(_mapped_region.get_address());
+            for (std::size_t pos = offset; pos < end; pos += cache_line_c)
+                OP_PREFETCH_READ(base + pos);
+        }
+
         void flush(bool async = true)
         {
             _mapped_region.flush(0, 0, async);
@@ -115,6 +131,9 @@ namespace OP::vtm
             }
         }
     private:
+        /** granularity of #prefetch */
+        constexpr static std::size_t cache_line_c = 64;
+
         bip::mapped_region _mapped_region;
 
         /** validate pointer against mapped region range*/
@@ -49,6 +49,15 @@ namespace OP::vtm
             return *opt_data;
         }
 
+        /** \return pointer to already cached region or nullptr, never creates new region */
+        const SegmentRegion* find(size_t pos)
+        {
+            std::shared_lock guard(_lock);
+            if (pos < _data.size() && _data[pos])
+                return &*_data[pos];
+            return nullptr;
+        }
+
         template <class FCallback>
         void for_each(FCallback f)
         {
@@ -56,6 +56,69 @@ namespace OP::vtm
             return result;
         }
 
+        /**
+        * Allocate and construct in-place Payload preferring the free entry that is close to `hint` (in the
+        * same page or at least in the same segment). Free list is not reordered, instead first
+        * #near_lookup_limit_c blocks of the list are inspected and the closest one is taken. If nothing better
+        * than the list head found it works exactly as #allocate.
+        *
+        *   \param hint - address of related entry (for example parent node), nil address means no preference.
+        *   \tparam Args - optional argument of Payload constructor.
+        */
+        template <class ... Args>
+        FarAddress allocate_near(FarAddress hint, Args&& ...args)
+        {
+            if (hint.is_nil())
+                return allocate(std::forward<Args>(args)...);
+            ZeroHeader* header = OP::vtm::template transactional_yield_retry_n<60>([this](){
+                    return segment_manager().template wr_at<ZeroHeader>(_zero_header_address);
+                });
+            if (header->_next == SegmentDef::far_null_c)
+                return allocate(std::forward<Args>(args)...);
+
+            far_pos_t best = SegmentDef::far_null_c, best_prev = SegmentDef::far_null_c;
+            unsigned best_distance = distance_to(hint, candidate_of(FarAddress(header->_next)));
+            far_pos_t prev = header->_next;
+            auto ro_head = segment_manager().readonly_block(FarAddress(header->_next), entry_size_c);
+            far_pos_t current = ro_head.template at<FreeBlockHeader>(0)->_next;
+            for (unsigned i = 1; best_distance && i < near_lookup_limit_c && current != SegmentDef::far_null_c; ++i)
+            {
+                auto ro_block = segment_manager().readonly_block(FarAddress(current), entry_size_c);
+                const auto* block = ro_block.template at<FreeBlockHeader>(0);
+                if (auto distance = distance_to(hint, candidate_of(FarAddress(current), block->_adjacent_count));
+                    distance < best_distance)
+                {
+                    best_distance = distance;
+                    best = current;
+                    best_prev = prev;
+                }
+                prev = current;
+                current = block->_next;
+            }
+            if (best == SegmentDef::far_null_c) //head is the best choice
+                return allocate(std::forward<Args>(args)...);
+
+            FarAddress result;
+            auto void_block = segment_manager().writable_block(
+                FarAddress(best), entry_size_c, WritableBlockHint::update_c);
+            auto* block = void_block.template at<FreeBlockHeader>(0);
+            if (block->_adjacent_count > 0)
+            {
+                result.address = best + entry_size_c * block->_adjacent_count;
+                --block->_adjacent_count;
+            }
+            else
+            {//unlink block from the middle of list
+                result.address = best;
+                segment_manager().template wr_at<FreeBlockHeader>(FarAddress(best_prev))->_next = block->_next;
+            }
+            new (segment_manager().template wr_at<payload_t>(result)) payload_t(std::forward<Args>(args)...);
+            header = segment_manager().template wr_at<ZeroHeader>(_zero_header_address);
+            --header->_in_free;
+            ++header->_in_alloc;
+            return result;
+        }
+
         /**
         * \param n - number of items to allocate. 0 is allowed but nothing is allocated
         */
@@ -123,10 +186,25 @@ namespace OP::vtm
 
         void deallocate(FarAddress addr)
         {
-            if( !is_valid_address(addr) )
+            deallocate_n(&addr, 1);
+        }
+
+        /**
+        * Release `n` entries at once. In compare with `n` calls of #deallocate the ZeroHeader is captured
+        * and updated only once, so it is preferable way to release big number of entries.
+        * \param addrs - array of `n` addresses to release, 0 is allowed but nothing is released
+        */
+        void deallocate_n(const FarAddress* addrs, size_t n)
+        {
+            if (n < 1)
+                return;
+            for (size_t i = 0; i < n; ++i)
             {
-                using namespace std::string_literals;
-                throw std::runtime_error("Address doesn't belong to "s + typeid(*this).name());
+                if (!is_valid_address(addrs[i]))
+                {
+                    using namespace std::string_literals;
+                    throw std::runtime_error("Address doesn't belong to "s + typeid(*this).name());
+                }
             }
 
             //capture ZeroHeader for write during 10 tries
@@ -135,18 +213,21 @@ namespace OP::vtm
                     return segment_manager().template wr_at<ZeroHeader>(_zero_header_address);
                 });
 
-            //following will raise ConcurrentLockException immediately, if 'addr' cannot be locked
-            auto entry = segment_manager().writable_block(
-                addr, entry_size_c, WritableBlockHint::block_for_write_c);
+            for (const FarAddress* addr = addrs; addr != addrs + n; ++addr)
+            {
+                //following will raise ConcurrentLockException immediately, if 'addr' cannot be locked
+                auto entry = segment_manager().writable_block(
+                    *addr, entry_size_c, WritableBlockHint::block_for_write_c);
 
-            payload_t* to_free = entry.template at<payload_t>(0);
-            to_free->~payload_t();
+                payload_t* to_free = entry.template at<payload_t>(0);
+                to_free->~payload_t();
 
-            auto just_freed = entry.template at<FreeBlockHeader>(0);
-            *just_freed = { header->_next, 0 };
-            header->_next = addr;
-            ++header->_in_free;
-            --header->_in_alloc;
+                auto just_freed = entry.template at<FreeBlockHeader>(0);
+                *just_freed = { header->_next, 0 };
+                header->_next = *addr;
+            }
+            header->_in_free += static_cast<std::uint32_t>(n);
+            header->_in_alloc -= static_cast<std::uint32_t>(n);
         }
 
         void _check_integrity(FarAddress segment_addr, bool) override
@@ -325,6 +406,31 @@ namespace OP::vtm
         }
 
     private:
+        /** Max number of free list blocks inspected by #allocate_near */
+        constexpr static unsigned near_lookup_limit_c = 8;
+        /** Granularity used by #allocate_near to consider entries close to each other */
+        constexpr static segment_pos_t near_page_c = 4096;
+
+        /** Address that would be allocated from the free block `block` with `adjacent_count` following entries */
+        static FarAddress candidate_of(FarAddress block, std::uint32_t adjacent_count) noexcept
+        {
+            return FarAddress(block.address + entry_size_c * adjacent_count);
+        }
+
+        FarAddress candidate_of(FarAddress block) const
+        {
+            auto ro_block = segment_manager().readonly_block(block, entry_size_c);
+            return candidate_of(block, ro_block.template at<FreeBlockHeader>(0)->_adjacent_count);
+        }
+
+        /** \return 0 - the same page, 1 - the same segment, 2 - other segment */
+        static unsigned distance_to(FarAddress hint, FarAddress candidate) noexcept
+        {
+            if (hint.segment() != candidate.segment())
+                return 2;
+            return (hint.offset() / near_page_c == candidate.offset() / near_page_c) ? 0 : 1;
+        }
+
         /**Size of entry in persistence state, must have capacity to accommodate ZeroHeader*/
         constexpr static const segment_pos_t entry_size_c =
             memory_requirement<FreeBlockHeader>::requirement > memory_requirement<Payload>::requirement 
@@ -146,9 +146,51 @@ void test_Finds(OP::utest::TestRuntime& tresult)
         tresult.assert_that<equals>(3 * 64, b3x.count_bits());
     }
 
+    void test_RankSelect(OP::utest::TestRuntime& tresult)
+    {
+        using bitset_t = OP::common::Bitset<4, std::uint64_t>;
+        bitset_t empty;
+        tresult.assert_that<equals>(0, empty.rank(0));
+        tresult.assert_that<equals>(0, empty.rank(255));
+        tresult.assert_that<equals>(bitset_t::nil_c, empty.select(0));
+
+        bitset_t b;
+        std::vector<bitset_t::dim_t> set_bits = { 0, 1, 7, 63, 64, 65, 127, 128, 200, 254, 255 };
+        for (auto i : set_bits)
+            b.set(i);
+        for (bitset_t::dim_t n = 0; n < set_bits.size(); ++n)
+        {
+            tresult.assert_that<equals>(n, b.rank(set_bits[n]), OP_CODE_DETAILS(<< "rank failed for " << set_bits[n]));
+            tresult.assert_that<equals>(set_bits[n], b.select(n), OP_CODE_DETAILS(<< "select failed for " << n));
+        }
+        tresult.assert_that<equals>(bitset_t::nil_c, b.select(static_cast<bitset_t::dim_t>(set_bits.size())));
+        //rank of absent bit is number of set bits below
+        tresult.assert_that<equals>(3, b.rank(8));
+        tresult.assert_that<equals>(7, b.rank(128));
+        tresult.assert_that<equals>(8, b.rank(129));
+        tresult.assert_that<equals>(b.count_bits(), b.rank(256));
+
+        bitset_t full(~0ull);
+        for (bitset_t::dim_t i = 0; i < 256; ++i)
+        {
+            tresult.assert_that<equals>(i, full.rank(i));
+            tresult.assert_that<equals>(i, full.select(i));
+        }
+
+        bitset_t odd, even;
+        for (bitset_t::dim_t i = 0; i < 256; ++i)
+            (i & 1) ? odd.set(i) : even.set(i);
+        auto un = odd | even;
+        tresult.assert_that<equals>(256, un.count_bits());
+        tresult.assert_that<equals>(128, odd.count_bits());
+        tresult.assert_that<equals>(255, (odd | empty).last_set());
+        tresult.assert_that<equals>(1, (odd | empty).first_set());
+    }
+
 static auto& module_suite = OP::utest::default_test_suite("Bitset")
 .declare("general", test_Basic)
 .declare("finds", test_Finds)
     .declare("count", test_Count)
+    .declare("rank-select", test_RankSelect)
 ;
 } //ns:
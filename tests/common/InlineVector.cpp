@@ -0,0 +1,91 @@
+#include <cassert>
+#include <vector>
+
+#include <op/utest/unit_test.h>
+#include <op/common/InlineVector.h>
+
+namespace {
+    using namespace OP;
+    using namespace OP::utest;
+
+    struct Point
+    {
+        Point() = default;
+        Point(int x, int y) noexcept : _x(x), _y(y) {}
+        int _x = 0, _y = 0;
+    };
+
+    using vec_t = InlineVector<Point, 4>;
+
+    void test_basic(OP::utest::TestRuntime& tresult)
+    {
+        vec_t v;
+        tresult.assert_true(v.empty());
+        tresult.assert_true(v.is_inline());
+        tresult.assert_that<equals>(vec_t::inline_capacity, v.capacity());
+
+        std::vector<int> expected;
+        for (int i = 0; i < 4; ++i)
+        {
+            v.emplace_back(i, -i);
+            expected.push_back(i);
+        }
+        tresult.assert_true(v.is_inline(), "no heap up to inline capacity");
+        v.push_back(v.back()); //refer to own element on relocation
+        tresult.assert_false(v.is_inline());
+        tresult.assert_that<equals>(5, v.size());
+        tresult.assert_that<equals>(3, v[4]._x);
+        tresult.assert_that<equals>(-3, v.back()._y);
+        v.pop_back();
+        expected.clear();
+        for (const auto& p : v)
+            expected.push_back(p._x);
+        tresult.assert_that<eq_sets>(expected, std::vector<int>{0, 1, 2, 3});
+
+        v.erase(v.begin() + 1, v.begin() + 3);
+        tresult.assert_that<equals>(2, v.size());
+        tresult.assert_that<equals>(3, v[1]._x);
+        v.truncate(1);
+        tresult.assert_that<equals>(0, v.back()._x);
+        v.clear();
+        tresult.assert_true(v.empty());
+    }
+
+    void test_copy_move(OP::utest::TestRuntime& tresult)
+    {
+        vec_t small;
+        small.emplace_back(1, 1);
+        vec_t small_copy(small);
+        tresult.assert_true(small_copy.is_inline());
+        small_copy.back()._x = 2;
+        tresult.assert_that<equals>(1, small.back()._x, "copies must be independent");
+
+        vec_t big;
+        for (int i = 0; i < 10; ++i)
+            big.emplace_back(i, i);
+        vec_t big_copy(big);
+        tresult.assert_that<equals>(10, big_copy.size());
+        tresult.assert_that<equals>(9, big_copy.back()._x);
+        big_copy[0]._x = 100;
+        tresult.assert_that<equals>(0, big[0]._x, "copies must be independent");
+
+        small_copy = big;
+        tresult.assert_that<equals>(10, small_copy.size());
+        tresult.assert_that<equals>(0, small_copy[0]._x);
+
+        vec_t moved(std::move(big));
+        tresult.assert_that<equals>(10, moved.size());
+        tresult.assert_true(big.empty());
+        tresult.assert_true(big.is_inline());
+
+        moved = std::move(small);
+        tresult.assert_that<equals>(1, moved.size());
+        tresult.assert_true(moved.is_inline());
+        tresult.assert_that<equals>(1, moved.back()._x);
+    }
+
+    static auto& module_suite = OP::utest::default_test_suite("InlineVector")
+        .declare("basic", test_basic)
+        .declare("copy-move", test_copy_move)
+        ;
+} //ns:
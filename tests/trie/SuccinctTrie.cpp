@@ -0,0 +1,182 @@
+#include <map>
+#include <random>
+#include <cstring>
+
+#include <op/utest/unit_test.h>
+#include <op/utest/unit_test_is.h>
+
+#include <op/common/astr.h>
+
+#include <op/trie/Trie.h>
+#include <op/trie/PlainValueManager.h>
+#include <op/trie/SuccinctTrie.h>
+#include <op/vtm/managers/BaseSegmentManager.h>
+
+#include "TrieTestUtils.h"
+#include "../vtm/MemoryChangeHistoryFixture.h"
+
+namespace
+{
+    using namespace OP::trie;
+    using namespace OP::vtm;
+    using namespace OP::utest;
+    using namespace OP::common;
+
+    const char* test_file_name = "trie-succinct.test";
+    using test_trie_t = Trie<
+        EventSourcingSegmentManager, OP::trie::PlainValueManager<double>, OP::common::atom_string_t>;
+    using succinct_t = SuccinctTrie<double>;
+
+    std::shared_ptr<test_trie_t> populate(std::shared_ptr<test::ChangeHistoryFactory> mem_change_history,
+        std::map<atom_string_t, double>& standard, size_t count)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto trie = test_trie_t::create_new(tmngr);
+        std::mt19937 random_gen(0x5cc7);
+        std::uniform_int_distribution<int> len_dist(1, 8), char_dist('a', 'h');
+        for (size_t i = 0; i < count; ++i)
+        {
+            atom_string_t key;
+            for (auto len = len_dist(random_gen); len; --len)
+                key.push_back(static_cast<atom_t>(char_dist(random_gen)));
+            if (trie->insert(key, static_cast<double>(i)).second)
+                standard.emplace(key, static_cast<double>(i));
+        }
+        return trie;
+    }
+
+    void test_Export(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::map<atom_string_t, double> standard;
+        auto trie = populate(mem_change_history, standard, 3000);
+        auto image = succinct_t::export_from(*trie);
+        const size_t image_size = image.size();
+        auto succinct = succinct_t::open(std::move(image));
+
+        tresult.assert_that<equals>(standard.size(), succinct->size(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(image_size, succinct->image_size(), OP_CODE_DETAILS());
+        size_t raw_size = 0;
+        for (const auto& [key, value] : standard)
+            raw_size += key.size() + sizeof(value);
+        tresult.info() << "image:" << image_size << " bytes, raw keys and values:" << raw_size
+            << " bytes, nodes:" << succinct->nodes_count() << "\n";
+        tresult.assert_that<less>(image_size, raw_size, OP_CODE_DETAILS());
+
+        auto i = succinct->begin();
+        for (const auto& [key, value] : standard)
+        {
+            tresult.assert_true(succinct->in_range(i), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(key, i.key(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(value, i.value(), OP_CODE_DETAILS());
+            succinct->next(i);
+        }
+        tresult.assert_false(succinct->in_range(i), OP_CODE_DETAILS());
+    }
+
+    void test_Navigation(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::map<atom_string_t, double> standard;
+        auto trie = populate(mem_change_history, standard, 1000);
+        auto image = succinct_t::export_from(*trie);
+        //image is accessed in-place without copy, like memory mapped file
+        auto succinct = succinct_t::open(image.data(), image.size());
+
+        std::mt19937 random_gen(0x10ad);
+        std::uniform_int_distribution<int> len_dist(0, 9), char_dist('a' - 1, 'h' + 1);
+        for (size_t n = 0; n < 2000; ++n)
+        {
+            atom_string_t probe;
+            for (auto len = len_dist(random_gen); len; --len)
+                probe.push_back(static_cast<atom_t>(char_dist(random_gen)));
+
+            auto expected = standard.find(probe);
+            auto found = succinct->find(probe);
+            tresult.assert_that<equals>(expected != standard.end(), !found.is_end(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(expected != standard.end(), succinct->check_exists(probe), OP_CODE_DETAILS());
+            if (expected != standard.end())
+                tresult.assert_that<equals>(expected->second, found.value(), OP_CODE_DETAILS());
+
+            auto expected_lower = standard.lower_bound(probe);
+            auto lower = succinct->lower_bound(probe);
+            tresult.assert_that<equals>(expected_lower == standard.end(), lower.is_end(), OP_CODE_DETAILS());
+            if (expected_lower != standard.end())
+                tresult.assert_that<equals>(expected_lower->first, lower.key(), OP_CODE_DETAILS());
+
+            std::map<atom_string_t, double> expected_prefixed;
+            for (; expected_lower != standard.end()
+                && expected_lower->first.compare(0, probe.size(), probe) == 0; ++expected_lower)
+                expected_prefixed.emplace(*expected_lower);
+            size_t count = 0;
+            for (const auto& i : succinct->prefixed_range(probe))
+            {
+                auto match = expected_prefixed.find(i.key());
+                tresult.assert_true(match != expected_prefixed.end(), OP_CODE_DETAILS());
+                tresult.assert_that<equals>(match->second, i.value(), OP_CODE_DETAILS());
+                ++count;
+            }
+            tresult.assert_that<equals>(expected_prefixed.size(), count, OP_CODE_DETAILS());
+        }
+    }
+
+    void test_Malformed(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::map<atom_string_t, double> standard;
+        auto trie = populate(mem_change_history, standard, 0);
+        auto image = succinct_t::export_from(*trie);
+        auto empty = succinct_t::open(image);
+        tresult.assert_that<equals>(0, empty->size(), OP_CODE_DETAILS());
+        tresult.assert_true(empty->begin().is_end(), OP_CODE_DETAILS());
+        tresult.assert_true(empty->find("a"_astr).is_end(), OP_CODE_DETAILS());
+        tresult.assert_true(empty->lower_bound(atom_string_t{}).is_end(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, empty->range() >>= OP::flur::apply::count(), OP_CODE_DETAILS());
+
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            SuccinctTrie<std::int32_t>::open(image); //different value type
+            });
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            succinct_t::open(std::vector<std::uint8_t>(image.begin(), image.end() - 8)); //truncated
+            });
+        image[0] ^= 0xFF;
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            succinct_t::open(image);
+            });
+
+        //header that points outside of the image is rejected before any array is touched
+        auto populated = populate(mem_change_history, standard, 100);
+        const auto origin = succinct_t::export_from(*populated);
+        auto assert_corrupted = [&](auto corrupt) {
+            auto corrupted = origin;
+            succinct::ImageHeader header;
+            std::memcpy(&header, corrupted.data(), sizeof(header));
+            corrupt(header);
+            std::memcpy(corrupted.data(), &header, sizeof(header));
+            tresult.assert_exception<std::invalid_argument>([&]() {
+                succinct_t::open(std::move(corrupted));
+                });
+        };
+        tresult.assert_that<equals>(standard.size(), succinct_t::open(origin)->size(), OP_CODE_DETAILS());
+        assert_corrupted([](succinct::ImageHeader& h) { h._louds._words_offset = h._image_size; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._louds._rank_offset += 4 * h._image_size; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._terminal._select0_offset = h._image_size - 1; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._terminal._words_offset += 1; }); //misaligned
+        assert_corrupted([](succinct::ImageHeader& h) { h._labels_offset = h._image_size - 1; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._values_offset = ~std::uint64_t{ 0 }; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._louds._bits *= 2; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._terminal._zeros = 0; });
+        assert_corrupted([](succinct::ImageHeader& h) { ++h._nodes; });
+        assert_corrupted([](succinct::ImageHeader& h) { h._terminals = h._nodes + 1; });
+    }
+
+    static auto& module_suite = OP::utest::default_test_suite("Trie.succinct")
+        .declare("export", test_Export)
+        .declare("navigation", test_Navigation)
+        .declare("malformed", test_Malformed)
+        .with_fixture("in-memory-history",
+            test::memory_change_history_factory<test::InMemoryChangeHistoryFactory>)
+        ;
+}//ns:""
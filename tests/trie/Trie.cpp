@@ -13,6 +13,8 @@
 #include <op/vtm/managers/BaseSegmentManager.h>
 
 #include <op/trie/JoinGenerator.h>
+#include <op/trie/ExpirySweeper.h>
+#include <op/common/ThreadPool.h>
 
 #include <algorithm>
 #include "../test_comparators.h"
@@ -30,6 +32,38 @@ namespace
     const char* test_file_name = "trie.test";
     using test_trie_t = Trie<
         EventSourcingSegmentManager, OP::trie::PlainValueManager<double>, OP::common::atom_string_t>;
+    /** trie that maintains per-node subtree counters to support rank/select */
+    using counted_trie_t = Trie<
+        EventSourcingSegmentManager, OP::trie::PlainValueManager<double>, OP::common::atom_string_t,
+        512, TrieFeature::subtree_counters>;
+    /** trie that rejects most of absent keys by MembershipFilter */
+    using filtered_trie_t = Trie<
+        EventSourcingSegmentManager, OP::trie::PlainValueManager<double>, OP::common::atom_string_t,
+        512, TrieFeature::membership_filter>;
+
+    /** \return random key of [1, max_len] characters in range ['a', last_char] */
+    atom_string_t random_key(OP::utest::TestRuntime& tresult, size_t max_len, char last_char)
+    {
+        atom_string_t key;
+        tresult.randomizer().random_str(key, max_len, 1, [&](size_t rnd) {
+            return static_cast<atom_t>('a' + rnd % (last_char - 'a' + 1));
+            });
+        return key;
+    }
+
+    /** Create trie of type TTrie over new storage file */
+    template <class TTrie>
+    std::shared_ptr<TTrie> make_trie(
+        const std::shared_ptr<test::ChangeHistoryFactory>& mem_change_history, const char* file_name)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        return TTrie::create_new(tmngr);
+    }
 
     void test_TrieCreation(OP::utest::TestRuntime& tresult,
         std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
@@ -203,6 +237,16 @@ namespace
         
         standard[stem4] = v_order++;
         compare_containers(tresult, *trie, standard);
+        // string ends exactly at the end of stem that already has child only
+        // Sequence: "mnop1", "mnop2", "mnop"
+        for (std::string key : {"mnop1", "mnop2", "mnop"})
+        {
+            ir5 = trie->insert(key, v_order);
+            tresult.assert_true(ir5.second, OP_CODE_DETAILS());
+            tresult.assert_that<eq_sets>(ir5.first.key(), key);
+            standard[key] = v_order++;
+        }
+        compare_containers(tresult, *trie, standard);
     }
 
     void test_TrieInsertGrow(OP::utest::TestRuntime& tresult,
@@ -1727,6 +1771,1192 @@ namespace
             );
     }
     
+    void test_TrieBulkLoad(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+
+        std::map<atom_string_t, double> test_values = {
+            {"a"_astr, 1.}, {"ab"_astr, 2.}, {"abc"_astr, 3.}, {"abcdef"_astr, 4.},
+            {"abd"_astr, 5.}, {"b"_astr, 6.}, {"bc.12"_astr, 7.}, {"bc.122x"_astr, 8.},
+            {"bc.123456789"_astr, 9.}, {"xyz"_astr, 10.}
+        };
+        //long stems
+        atom_string_t long_key(300, 'q');
+        test_values.emplace(long_key, 11.);
+        test_values.emplace(long_key + "a"_astr, 12.);
+        test_values.emplace(long_key.substr(0, 270) + "z"_astr, 13.);
+        //wide nodes to exercise all capacities
+        for (unsigned i = 0; i < 256; ++i)
+        {
+            atom_string_t key = "w"_astr;
+            key += static_cast<atom_t>(i);
+            test_values.emplace(key, i);
+            if (i < 20)
+            {
+                key += static_cast<atom_t>(i);
+                test_values.emplace(key, -1. * i);
+            }
+        }
+
+        auto loaded = trie->bulk_load(src::of_container(test_values));
+        tresult.assert_that<equals>(test_values.size(), loaded, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(test_values.size(), trie->size(), OP_CODE_DETAILS());
+        compare_containers(tresult, *trie, test_values);
+        for (const auto& [key, value] : test_values)
+        {
+            auto found = trie->find(key);
+            tresult.assert_false(trie->end() == found, OP_CODE_DETAILS());
+            tresult.assert_that<equals>(value, found.value(), OP_CODE_DETAILS());
+        }
+
+        //result must be the same as produced by regular insert
+        {
+            auto tmngr2 = std::shared_ptr<EventSourcingSegmentManager>(
+                new EventSourcingSegmentManager(
+                    BaseSegmentManager::create_new(
+                        "trie-bulk.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                    mem_change_history->create()
+                ));
+            auto trie2 = trie_t::create_new(tmngr2);
+            for (const auto& [key, value] : test_values)
+                trie2->insert(key, value);
+            tresult.assert_that<equals>(trie2->nodes_count(), trie->nodes_count(), OP_CODE_DETAILS());
+        }
+
+        //regular modifications must work over loaded trie
+        tresult.assert_true(trie->insert("abce"_astr, 100.).second);
+        test_values.emplace("abce"_astr, 100.);
+        trie->erase(trie->find("abc"_astr));
+        test_values.erase("abc"_astr);
+        compare_containers(tresult, *trie, test_values);
+
+        //only empty trie can be loaded
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            trie->bulk_load(src::of_container(std::map<atom_string_t, double>{ {"k"_astr, 0.} }));
+            });
+
+        auto tmngr3 = std::shared_ptr<EventSourcingSegmentManager>(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-bulk.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto trie3 = trie_t::create_new(tmngr3);
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            trie3->bulk_load(src::of_container(std::vector<std::pair<atom_string_t, double>>{
+                {"b"_astr, 0.}, {"a"_astr, 1.} }));
+            });
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            trie3->bulk_load(src::of_container(std::vector<std::pair<atom_string_t, double>>{
+                {"ab"_astr, 0.}, {"ab"_astr, 1.} }));
+            });
+        tresult.assert_that<equals>(0, trie3->size(), OP_CODE_DETAILS());
+    }
+
+    void test_TrieFindMany(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+
+        std::map<atom_string_t, double> test_values;
+        const atom_string_t long_stem(270, 'l');
+        for (auto prefix : { "a"_astr, "ab"_astr, "abc"_astr, "b"_astr, "bcdefg"_astr, long_stem })
+        {
+            for (atom_t c = 'a'; c < 'f'; ++c)
+            {
+                test_values.emplace(prefix + atom_string_t(1, c), c);
+                test_values.emplace(prefix + atom_string_t(1, c) + long_stem, -c);
+            }
+        }
+        test_values.emplace("abc"_astr, 0.);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+
+        std::vector<atom_string_t> query;
+        for (const auto& [key, _] : test_values)
+        {
+            query.push_back(key);
+            //absent keys: prefix of stem, shorter/longer keys, diverge in the middle of stem
+            query.push_back(key + "z"_astr);
+            query.push_back(key.substr(0, key.size() - 1));
+            if (key.size() > 10)
+                query.push_back(key.substr(0, 5) + "?"_astr);
+        }
+        query.push_back(atom_string_t{});
+        query.push_back("zzz"_astr);
+        query.push_back("a"_astr); //out of order
+        std::vector<bool> expected_exists;
+        for (const auto& key : query)
+            expected_exists.push_back(test_values.find(key) != test_values.end());
+
+        std::vector<bool> exists;
+        trie->check_exists_many(query, std::back_inserter(exists));
+        tresult.assert_that<eq_sets>(expected_exists, exists, OP_CODE_DETAILS());
+
+        std::vector<trie_t::iterator> found(query.size(), trie->end());
+        auto last = trie->find_many(query, found.begin());
+        tresult.assert_true(last == found.end(), OP_CODE_DETAILS());
+        for (size_t i = 0; i < query.size(); ++i)
+        {
+            auto expected = test_values.find(query[i]);
+            if (expected == test_values.end())
+            {
+                tresult.assert_true(found[i].is_end(), OP_CODE_DETAILS());
+                continue;
+            }
+            tresult.assert_false(found[i].is_end(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(expected->first, found[i].key(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(expected->second, found[i].value(), OP_CODE_DETAILS());
+            //result is a regular iterator
+            tresult.assert_true(trie->find(query[i]) == found[i], OP_CODE_DETAILS());
+        }
+    }
+
+    /** Second level node passes all layouts (dense 4, 16, 48 and 256 table) on grow and keeps order on erase */
+    void test_TrieAdaptiveNode(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        auto random_gen = tools::RandomGenerator::instance().generator();
+
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+
+        std::map<atom_string_t, double> test_values;
+        //force 2-level node
+        trie->insert("pa"_astr, 0.);
+        trie->insert("pb"_astr, 0.);
+        test_values.emplace("pa"_astr, 0.);
+        test_values.emplace("pb"_astr, 0.);
+        std::map<std::uint16_t, atom_string_t> key_of{ {'a', "pa"_astr}, {'b', "pb"_astr} };
+        const auto nodes_before = trie->nodes_count();
+
+        std::array<std::uint16_t, 256> rand_idx{};
+        std::iota(std::begin(rand_idx), std::end(rand_idx), 0);
+        std::shuffle(std::begin(rand_idx), std::end(rand_idx), random_gen);
+        const atom_string_t stems[] = { ""_astr, "s"_astr, atom_string_t(40, 'x') };
+        const std::set<size_t> layout_bounds{ 4, 5, 16, 17, 48, 49, 255, 256 };
+
+        size_t n = 0;
+        for (auto i : rand_idx)
+        {
+            atom_string_t key = "p"_astr + atom_string_t(1, static_cast<atom_t>(i)) + stems[i % std::extent_v<decltype(stems)>];
+            if (key_of.count(i))
+                continue; //'pa', 'pb' already there
+            key_of.emplace(i, key);
+            tresult.assert_true(trie->insert(key, static_cast<double>(i)).second, OP_CODE_DETAILS());
+            test_values.emplace(key, static_cast<double>(i));
+            if (layout_bounds.count(++n))
+                compare_containers(tresult, *trie, test_values);
+        }
+        //all went to the same node
+        tresult.assert_that<equals>(nodes_before, trie->nodes_count(), OP_CODE_DETAILS());
+        compare_containers(tresult, *trie, test_values);
+
+        std::shuffle(std::begin(rand_idx), std::end(rand_idx), random_gen);
+        n = test_values.size();
+        for (auto i : rand_idx)
+        {
+            if ((i & 1) && n > 40)
+            {// keep child of some entries to check partial erase
+                atom_string_t sub = "p"_astr + atom_string_t(1, static_cast<atom_t>(i)) + "-child"_astr;
+                trie->insert(sub, -1.);
+                test_values.emplace(sub, -1.);
+            }
+            auto found = trie->find(key_of[i]);
+            tresult.assert_false(found.is_end(), OP_CODE_DETAILS());
+            trie->erase(found);
+            test_values.erase(key_of[i]);
+            if (layout_bounds.count(--n))
+                compare_containers(tresult, *trie, test_values);
+        }
+        compare_containers(tresult, *trie, test_values);
+        tresult.assert_that<equals>(
+            test_values.size(), trie->prefixed_key_erase_all("p"_astr), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, trie->size(), OP_CODE_DETAILS());
+    }
+
+    void test_TrieSnapshot(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        tresult.assert_true(trie->snapshot().empty(), OP_CODE_DETAILS());
+
+        std::map<atom_string_t, double> test_values;
+        for (auto prefix : { "a"_astr, "ab"_astr, "abc"_astr, "b"_astr, "bcd"_astr, atom_string_t(50, 'z') })
+            for (atom_t c = 'a'; c < 'e'; ++c)
+                test_values.emplace(prefix + atom_string_t(1, c), c);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+
+        auto snap = trie->snapshot();
+        auto prefixed_snap = trie->snapshot("ab"_astr);
+        tresult.assert_that<equals>(trie->version(), snap.version(), OP_CODE_DETAILS());
+
+        //writers don't affect snapshot
+        const auto origin_values = test_values;
+        trie->insert("abx"_astr, 1.);
+        trie->erase(trie->find("aba"_astr));
+        trie->prefixed_key_erase_all("b"_astr);
+        tresult.assert_true(trie->version() != snap.version(), OP_CODE_DETAILS());
+
+        auto same_entry = [](const auto& left, const auto& right) {
+            return left.first == right.first && left.second == right.second; };
+        tresult.assert_that<equals>(origin_values.size(), snap.size(), OP_CODE_DETAILS());
+        tresult.assert_true(std::equal(origin_values.begin(), origin_values.end(), snap.begin(), snap.end(), same_entry),
+            OP_CODE_DETAILS());
+        tresult.assert_that<equals>(origin_values.size(), snap.range() >>= apply::count(), OP_CODE_DETAILS());
+
+        std::map<atom_string_t, double> expected_prefixed;
+        for (const auto& [key, value] : origin_values)
+            if (key.substr(0, 2) == "ab"_astr)
+                expected_prefixed.emplace(key, value);
+        tresult.assert_true(std::equal(expected_prefixed.begin(), expected_prefixed.end(),
+            prefixed_snap.begin(), prefixed_snap.end(), same_entry), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(expected_prefixed.size(),
+            snap.prefixed_range("ab"_astr) >>= apply::count(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, snap.prefixed_range("abz"_astr) >>= apply::count(), OP_CODE_DETAILS());
+
+        tresult.assert_true(snap.find("aba"_astr) != snap.end(), OP_CODE_DETAILS());
+        tresult.assert_true(snap.find("abx"_astr) == snap.end(), OP_CODE_DETAILS());
+        tresult.assert_true(snap.find("abe"_astr) == snap.end(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>("abc"_astr, snap.lower_bound("abbz"_astr)->first, OP_CODE_DETAILS());
+        //new snapshot sees changes
+        auto fresh_snap = trie->snapshot("ab"_astr);
+        tresult.assert_true(fresh_snap.find("abx"_astr) != fresh_snap.end(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(trie->size(), trie->snapshot().size(), OP_CODE_DETAILS());
+
+        //steady ingest doesn't break snapshot, each copy is a consistent prefix of inserted sequence
+        constexpr size_t ingest_count = 2000;
+        auto ingest_key = [](size_t i) {
+            auto digits = std::to_string(100000 + i);
+            return "ingest"_astr + atom_string_t(digits.begin(), digits.end());
+        };
+        std::atomic<bool> ingest_done = false;
+        std::thread writer([&]() {
+            for (size_t i = 0; i < ingest_count; ++i)
+                trie->insert(ingest_key(i), static_cast<double>(i));
+            ingest_done = true;
+        });
+        size_t snapshots = 0;
+        bool consistent = true;
+        while (!ingest_done || snapshots == 0)
+        {
+            auto ingest_snap = trie->snapshot("ingest"_astr);
+            size_t n = 0;
+            for (const auto& [key, value] : ingest_snap)
+                consistent = consistent && key == ingest_key(n) && value == static_cast<double>(n++);
+            ++snapshots;
+        }
+        writer.join();
+        tresult.assert_true(consistent, "snapshot must contain exactly the keys inserted before it");
+        tresult.assert_that<equals>(ingest_count, trie->snapshot("ingest"_astr).size(), OP_CODE_DETAILS());
+    }
+
+    void test_TrieSubtreeCount(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = counted_trie_t;
+        std::map<atom_string_t, double> test_values;
+
+        auto starts_with = [](const atom_string_t& str, const atom_string_t& prefix) {
+            return str.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), str.begin());
+        };
+        auto check = [&](const trie_t& trie) {
+            tresult.assert_that<equals>(test_values.size(), trie.count_prefix(atom_string_t{}), OP_CODE_DETAILS());
+            std::set<atom_string_t> probes{ atom_string_t{}, "zzz"_astr, atom_string_t(1, 0) };
+            for (const auto& [key, _] : test_values)
+                for (size_t len = 1; len <= key.size() + 1; ++len)
+                    probes.insert(key.substr(0, len - 1) + (len > key.size() ? "a"_astr : atom_string_t{}));
+            for (const auto& probe : probes)
+            {
+                auto lower = test_values.lower_bound(probe);
+                tresult.assert_that<equals>(
+                    static_cast<std::uint64_t>(std::distance(test_values.begin(), lower)), trie.rank(probe),
+                    OP_CODE_DETAILS());
+                std::uint64_t expected_count = 0;
+                for (auto i = lower; i != test_values.end() && starts_with(i->first, probe); ++i)
+                    ++expected_count;
+                tresult.assert_that<equals>(expected_count, trie.count_prefix(probe), OP_CODE_DETAILS());
+                for (std::uint64_t nth : { std::uint64_t{0}, expected_count / 2, expected_count - 1, expected_count })
+                {
+                    auto found = trie.select(probe, nth);
+                    if (nth >= expected_count)
+                    {
+                        tresult.assert_true(found.is_end(), OP_CODE_DETAILS());
+                        continue;
+                    }
+                    tresult.assert_false(found.is_end(), OP_CODE_DETAILS());
+                    tresult.assert_that<equals>(std::next(lower, nth)->first, found.key(), OP_CODE_DETAILS());
+                    tresult.assert_that<equals>(std::next(lower, nth)->second, found.value(), OP_CODE_DETAILS());
+                }
+            }
+        };
+
+        for (size_t i = 0; i < 300; ++i)
+        {
+            auto key = random_key(tresult, 7, 'c');
+            test_values.emplace(key, static_cast<double>(key.size()));
+        }
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+        check(*trie);
+
+        //erase every third
+        size_t n = 0;
+        for (auto i = test_values.begin(); i != test_values.end(); ++n)
+        {
+            if (n % 3)
+            {
+                ++i;
+                continue;
+            }
+            trie->erase(trie->find(i->first));
+            i = test_values.erase(i);
+        }
+        check(*trie);
+        //erase subtrees
+        auto erase_prefixed = [&](const atom_string_t& prefix) {
+            for (auto i = test_values.lower_bound(prefix); i != test_values.end() && starts_with(i->first, prefix); )
+                i = test_values.erase(i);
+        };
+        trie->prefixed_key_erase_all("ab"_astr);
+        erase_prefixed("ab"_astr);
+        auto ca = trie->find("ca"_astr);
+        if (!ca.is_end())
+        {
+            auto removed = trie->prefixed_erase_all(ca);
+            auto expected_removed = test_values.size();
+            erase_prefixed("ca"_astr);
+            tresult.assert_that<equals>(expected_removed - test_values.size(), removed, OP_CODE_DETAILS());
+        }
+        check(*trie);
+        //upsert existing don't change counters
+        for (auto& [key, value] : test_values)
+        {
+            value = -value;
+            trie->upsert(key, -trie->find(key).value());
+        }
+        check(*trie);
+
+        //bulk constructed trie has the same counters
+        std::shared_ptr<EventSourcingSegmentManager> tmngr2(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-count.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> bulk_trie = trie_t::create_new(tmngr2);
+        bulk_trie->bulk_load(src::of_container(std::cref(test_values)));
+        check(*bulk_trie);
+        bulk_trie.reset();
+        tmngr2.reset();
+
+        //storage created with counters cannot be opened by trie of other layout
+        std::shared_ptr<EventSourcingSegmentManager> tmngr3(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::open("trie-count.test"),
+                mem_change_history->create()
+            ));
+        tresult.assert_exception<OP::Exception>([&]() {
+            test_trie_t::open(tmngr3);
+            });
+        check(*trie_t::open(tmngr3));
+    }
+
+    void test_TrieBatch(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = counted_trie_t;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        std::shared_ptr<EventSourcingSegmentManager> tmngr2(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-batch.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        //the same operations applied one by one in the key order
+        std::shared_ptr<trie_t> single = trie_t::create_new(tmngr2);
+        std::map<atom_string_t, double> standard;
+
+        for (size_t round = 0; round < 4; ++round)
+        {
+            auto batch = trie->batch();
+            std::vector<std::tuple<atom_string_t, int, double>> queue;
+            for (size_t i = 0; i < 200; ++i)
+            {
+                auto key = random_key(tresult, 6, 'd');
+                const double value = static_cast<double>(round * 1000 + i);
+                const int op = tresult.randomizer().next_in_range(0, 3);
+                switch (op)
+                {
+                case 0:
+                    batch.insert(key, value);
+                    standard.emplace(key, value);
+                    break;
+                case 1:
+                    batch.upsert(key, value);
+                    standard[key] = value;
+                    break;
+                default:
+                    batch.erase(key);
+                    standard.erase(key);
+                }
+                queue.emplace_back(key, op, value);
+            }
+            std::stable_sort(queue.begin(), queue.end(), [](const auto& left, const auto& right) {
+                return std::get<0>(left) < std::get<0>(right);
+                });
+            for (const auto& [key, op, value] : queue)
+            {
+                if (op == 0)
+                    single->insert(key, value);
+                else if (op == 1)
+                    single->upsert(key, double(value));
+                else if (auto found = single->find(key); !found.is_end())
+                    single->erase(found);
+            }
+            tresult.assert_that<equals>(200, batch.size(), OP_CODE_DETAILS());
+            auto version = trie->version();
+            batch.apply();
+            tresult.assert_that<equals>(0, batch.size(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(version + 1, trie->version(), OP_CODE_DETAILS());
+
+            compare_containers(tresult, *trie, standard);
+            tresult.assert_that<equals>(standard.size(), trie->size(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(single->nodes_count(), trie->nodes_count(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(standard.size(), trie->count_prefix(atom_string_t{}), OP_CODE_DETAILS());
+        }
+        //operations over the same key are applied in the queue order
+        auto batch = trie->batch();
+        batch.upsert("a"_astr, 1.).erase("a"_astr).insert("a"_astr, 2.).insert("a"_astr, 3.);
+        batch.apply();
+        tresult.assert_that<equals>(2., trie->find("a"_astr).value(), OP_CODE_DETAILS());
+        //empty keys and missing keys don't modify trie
+        auto version = trie->version();
+        batch.erase(atom_string_t{}).erase("zzzzzzz"_astr).insert(atom_string_t{}, 1.);
+        tresult.assert_that<equals>(0, batch.apply(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(version, trie->version(), OP_CODE_DETAILS());
+    }
+
+    void test_TrieMembershipFilter(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = filtered_trie_t;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        std::set<atom_string_t> standard;
+        const auto initial_capacity = trie->filter_capacity();
+        tresult.assert_that<greater>(initial_capacity, 0, OP_CODE_DETAILS());
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            auto key = random_key(tresult, 8, 'h');
+            trie->insert(key, static_cast<double>(i));
+            standard.insert(key);
+        }
+        //filter grows with the number of keys
+        auto batch = trie->batch();
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            auto key = random_key(tresult, 8, 'h');
+            batch.insert(key, static_cast<double>(i));
+            standard.insert(key);
+        }
+        batch.apply();
+        tresult.assert_that<equals>(standard.size(), trie->size(), OP_CODE_DETAILS());
+        tresult.assert_that<greater_or_equals>(trie->filter_capacity(), trie->size(), OP_CODE_DETAILS());
+        tresult.assert_that<greater>(trie->filter_capacity(), initial_capacity, OP_CODE_DETAILS());
+        //keys inserted relative to prefix are visible to filter as well
+        auto [prefix, _] = trie->insert("prefix"_astr, 0.);
+        standard.insert("prefix"_astr);
+        trie->prefixed_insert(prefix, ".suffix"_astr, 1.);
+        standard.insert("prefix.suffix"_astr);
+
+        auto check_all = [&]() {
+            for (const auto& key : standard)
+            {
+                tresult.assert_true(trie->check_exists(key), OP_CODE_DETAILS() << "missed key");
+                tresult.assert_false(trie->find(key).is_end(), OP_CODE_DETAILS());
+            }
+            std::vector<atom_string_t> probes(standard.begin(), standard.end());
+            for (size_t i = 0; i < 1000; ++i)
+                probes.push_back(random_key(tresult, 8, 'h'));
+            std::sort(probes.begin(), probes.end());
+            std::vector<bool> exists;
+            trie->check_exists_many(probes, std::back_inserter(exists));
+            std::vector<trie_t::iterator> found;
+            trie->find_many(probes, std::back_inserter(found));
+            for (size_t i = 0; i < probes.size(); ++i)
+            {
+                const bool expected = standard.count(probes[i]) != 0;
+                tresult.assert_that<equals>(expected, trie->check_exists(probes[i]), OP_CODE_DETAILS());
+                tresult.assert_that<equals>(expected, exists[i], OP_CODE_DETAILS());
+                tresult.assert_that<equals>(expected, !found[i].is_end(), OP_CODE_DETAILS());
+            }
+        };
+        check_all();
+        tresult.assert_that<equals>(0, trie->filter_stale_count(), OP_CODE_DETAILS());
+
+        //rollback discards filter changes together with the trie
+        {
+            OP::vtm::TransactionGuard g(tmngr->begin_transaction());
+            trie->insert("rolled-back"_astr, 1.);
+        }
+        tresult.assert_false(trie->check_exists("rolled-back"_astr), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, trie->filter_stale_count(), OP_CODE_DETAILS());
+
+        //erased keys remain in the filter until rebuild
+        size_t erased = 0;
+        for (auto i = standard.begin(); i != standard.end(); ++erased)
+        {
+            auto pos = trie->find(*i);
+            trie->erase(pos);
+            i = standard.erase(i);
+            if (i != standard.end())
+                ++i;
+        }
+        tresult.assert_that<equals>(erased, trie->filter_stale_count(), OP_CODE_DETAILS());
+        check_all();
+        const auto grown_capacity = trie->filter_capacity();
+        trie->rebuild_filter();
+        tresult.assert_that<equals>(0, trie->filter_stale_count(), OP_CODE_DETAILS());
+        //rebuild shrinks filter to the actual number of keys
+        tresult.assert_that<greater_or_equals>(trie->filter_capacity(), trie->size(), OP_CODE_DETAILS());
+        tresult.assert_that<less>(trie->filter_capacity(), grown_capacity, OP_CODE_DETAILS());
+        check_all();
+
+        //bulk loaded trie gets filter of fitting size at once
+        std::shared_ptr<EventSourcingSegmentManager> tmngr2(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-filter.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        trie = trie_t::create_new(tmngr2);
+        trie->bulk_load(src::of_container(std::cref(standard))
+            >> then::mapping([](const auto& key) { return std::make_pair(key, 1.); }));
+        tresult.assert_that<greater_or_equals>(trie->filter_capacity(), trie->size(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, trie->filter_stale_count(), OP_CODE_DETAILS());
+        check_all();
+        //filter is persisted together with the trie
+        trie.reset();
+        tmngr2.reset(new EventSourcingSegmentManager(
+            BaseSegmentManager::open("trie-filter.test"),
+            mem_change_history->create()
+        ));
+        trie = trie_t::open(tmngr2);
+        check_all();
+        //storage without filter cannot be opened as filtered one
+        std::shared_ptr<EventSourcingSegmentManager> unfiltered_mngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-unfiltered.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        test_trie_t::create_new(unfiltered_mngr);
+        tresult.assert_exception<OP::Exception>([&]() { trie_t::open(unfiltered_mngr); });
+
+        //filter of max size stops growing, so inserts don't re-populate it
+        std::shared_ptr<EventSourcingSegmentManager> tmngr3(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-filter-max.test", OP::vtm::SegmentOptions().segment_size(0x20000)),
+                mem_change_history->create()
+            ));
+        trie = trie_t::create_new(tmngr3);
+        standard.clear();
+        size_t max_capacity = 0;
+        for (size_t i = 0; i < 100000 && (max_capacity == 0 || trie->size() < max_capacity + 100); ++i)
+        {
+            std::string digits = std::to_string(i * 7919);
+            atom_string_t key(digits.begin(), digits.end());
+            trie->insert(key, 1.);
+            standard.insert(key);
+            if (max_capacity == 0 && trie->filter_capacity() < trie->size())
+                max_capacity = trie->filter_capacity(); //filter cannot grow anymore
+        }
+        tresult.assert_that<greater>(max_capacity, 0, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(max_capacity, trie->filter_capacity(), OP_CODE_DETAILS());
+        std::vector<bool> exists;
+        trie->check_exists_many(standard, std::back_inserter(exists));
+        tresult.assert_true(std::all_of(exists.begin(), exists.end(), [](bool b) { return b; }), OP_CODE_DETAILS());
+    }
+
+    void test_TrieCompaction(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = test_trie_t;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        std::map<atom_string_t, double> standard;
+
+        for (size_t i = 0; i < 5000; ++i)
+        {
+            auto key = random_key(tresult, 10, 'z');
+            if (trie->insert(key, static_cast<double>(i)).second)
+                standard.emplace(key, static_cast<double>(i));
+        }
+        //leave every 10th key to produce fragmented storage
+        size_t n = 0;
+        for (auto i = standard.begin(); i != standard.end(); ++n)
+        {
+            if (n % 10 == 0)
+            {
+                ++i;
+                continue;
+            }
+            auto pos = trie->find(i->first);
+            trie->erase(pos);
+            i = standard.erase(i);
+        }
+        compare_containers(tresult, *trie, standard);
+
+        std::shared_ptr<EventSourcingSegmentManager> target(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-compact.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        //small chunks, so copy spans many transactions of the target
+        auto report = trie->compact_to(target, 64);
+        tresult.assert_that<equals>(standard.size(), report._count, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(standard.size(), report._trie->size(), OP_CODE_DETAILS());
+        compare_containers(tresult, *report._trie, standard);
+        tresult.assert_that<equals>(trie->nodes_count(), report._source_nodes, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(report._trie->nodes_count(), report._target_nodes, OP_CODE_DETAILS());
+        tresult.assert_that<less>(report._target_nodes, report._source_nodes, OP_CODE_DETAILS());
+        tresult.assert_that<less>(0, report.reclaimed(), OP_CODE_DETAILS()
+            << "source:" << report._source_bytes << ", target:" << report._target_bytes);
+        //source stays untouched
+        compare_containers(tresult, *trie, standard);
+        //compacted trie is fully functional
+        for (const auto& [key, value] : standard)
+            tresult.assert_true(report._trie->check_exists(key), OP_CODE_DETAILS());
+        tresult.assert_true(report._trie->insert("new-key"_astr, 1.).second, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(standard.size() + 1, report._trie->size(), OP_CODE_DETAILS());
+    }
+
+    void test_TrieMinimize(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = counted_trie_t;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        std::map<atom_string_t, double> standard;
+        //all hosts share the same set of paths, value depends on path only
+        const std::string paths[] = {
+            "/index.html", "/about/team.html", "/about/contacts.html",
+            "/blog/2024/first-post.html", "/blog/2024/second-post.html", "/img/logo.png" };
+        for (size_t host = 0; host < 40; ++host)
+        {
+            std::string prefix = "https://host" + std::to_string(host) + ".example.org";
+            for (size_t p = 0; p < std::size(paths); ++p)
+            {
+                const std::string url = prefix + paths[p];
+                atom_string_t key(url.begin(), url.end());
+                trie->insert(key, static_cast<double>(p));
+                standard.emplace(key, static_cast<double>(p));
+            }
+        }
+        auto compact_mngr = std::shared_ptr<EventSourcingSegmentManager>(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-compact.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto compact = trie->compact_to(compact_mngr);
+        tresult.assert_false(compact._trie->is_minimized(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, compact._shared_nodes, OP_CODE_DETAILS());
+
+        auto target = std::shared_ptr<EventSourcingSegmentManager>(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-minimize.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto report = trie->minimize_to(target);
+        auto& minimized = *report._trie;
+        tresult.assert_true(minimized.is_minimized(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(standard.size(), report._count, OP_CODE_DETAILS());
+        tresult.info() << "nodes compacted:" << compact._target_nodes
+            << ", minimized:" << report._target_nodes << ", shared references:" << report._shared_nodes << "\n";
+        tresult.assert_that<less>(0, report._shared_nodes, OP_CODE_DETAILS());
+        tresult.assert_that<less>(report._target_nodes * 10, compact._target_nodes, OP_CODE_DETAILS());
+        compare_containers(tresult, minimized, standard);
+        //navigation and subtree counters work over shared nodes
+        for (const auto& [key, value] : standard)
+        {
+            auto found = minimized.find(key);
+            tresult.assert_false(found.is_end(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(value, found.value(), OP_CODE_DETAILS());
+        }
+        tresult.assert_false(minimized.check_exists("https://host1.example.org/about"_astr), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(3,
+            minimized.count_prefix("https://host7.example.org/about/"_astr) + minimized.count_prefix("https://host7.example.org/img"_astr),
+            OP_CODE_DETAILS());
+        auto lower = minimized.lower_bound("https://host12.example.org/b"_astr);
+        tresult.assert_that<eq_sets>(lower.key(), "https://host12.example.org/blog/2024/first-post.html"_astr, OP_CODE_DETAILS());
+
+        //any modification is prohibited
+        tresult.assert_exception<std::logic_error>([&]() {
+            minimized.insert("https://new.example.org"_astr, 0.);
+            });
+        tresult.assert_exception<std::logic_error>([&]() {
+            auto pos = minimized.find("https://host1.example.org/index.html"_astr);
+            minimized.erase(pos);
+            });
+        tresult.assert_exception<std::logic_error>([&]() {
+            minimized.prefixed_key_erase_all("https://host1"_astr);
+            });
+        compare_containers(tresult, minimized, standard);
+        //flag is persisted
+        report._trie.reset();
+        auto reopened = trie_t::open(target);
+        tresult.assert_true(reopened->is_minimized(), OP_CODE_DETAILS());
+        compare_containers(tresult, *reopened, standard);
+
+        //compaction of minimized trie gives writable copy
+        auto writable_mngr = std::shared_ptr<EventSourcingSegmentManager>(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "trie-unshared.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto writable = reopened->compact_to(writable_mngr)._trie;
+        tresult.assert_false(writable->is_minimized(), OP_CODE_DETAILS());
+        auto pos = writable->find("https://host1.example.org/index.html"_astr);
+        writable->erase(pos);
+        standard.erase("https://host1.example.org/index.html"_astr);
+        compare_containers(tresult, *writable, standard);
+        //shared suffix of other hosts is not affected
+        tresult.assert_true(writable->check_exists("https://host2.example.org/index.html"_astr), OP_CODE_DETAILS());
+    }
+
+    void test_TrieLeapfrogJoin(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = test_trie_t;
+        const char* file_names[] = { test_file_name, "trie-leapfrog1.test", "trie-leapfrog2.test" };
+        std::shared_ptr<trie_t> tries[std::size(file_names)];
+        std::set<atom_string_t> standards[std::size(file_names)];
+
+        for (size_t t = 0; t < std::size(file_names); ++t)
+        {
+            std::shared_ptr<EventSourcingSegmentManager> tmngr(
+                new EventSourcingSegmentManager(
+                    BaseSegmentManager::create_new(
+                        file_names[t], OP::vtm::SegmentOptions().segment_size(0x110000)),
+                    mem_change_history->create()
+                ));
+            tries[t] = trie_t::create_new(tmngr);
+            for (size_t i = 0; i < 600; ++i)
+            {
+                auto key = random_key(tresult, 4, 'f');
+                tries[t]->insert(key, static_cast<double>(i));
+                standards[t].insert(key);
+            }
+        }
+        std::set<atom_string_t> ordered_src;
+        for (const auto& key : standards[0])
+            if (key.size() % 2 == 0 || key.back() == 'a')
+                ordered_src.insert(key);
+
+        auto intersect = [](const auto& left, const auto& right) {
+            std::set<atom_string_t> result;
+            std::set_intersection(left.begin(), left.end(), right.begin(), right.end(),
+                std::inserter(result, result.end()));
+            return result;
+        };
+        auto expected = intersect(intersect(standards[0], standards[1]), standards[2]);
+        tresult.assert_false(expected.empty(), OP_CODE_DETAILS());
+
+        auto three_tries = src::leapfrog_join(tries[0], tries[1], tries[2]);
+        tresult.assert_that<eq_sets>(three_tries, expected, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(expected.size(), three_tries >>= apply::count(), OP_CODE_DETAILS());
+
+        //mix of tries and ordered sequence
+        auto mixed = src::leapfrog_join(
+            tries[2], src::of_container(ordered_src), tries[1]);
+        tresult.assert_that<eq_sets>(mixed, intersect(expected, ordered_src), OP_CODE_DETAILS());
+
+        //single participant yields itself
+        tresult.assert_that<eq_sets>(src::leapfrog_join(tries[1]), standards[1], OP_CODE_DETAILS());
+
+        //any empty participant produces empty result
+        tresult.assert_that<equals>(0,
+            src::leapfrog_join(tries[0], src::of_container(std::set<atom_string_t>{})) >>= apply::count(),
+            OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0,
+            src::leapfrog_join(src::of_container(std::set<atom_string_t>{"zz"_astr}), tries[0]) >>= apply::count(),
+            OP_CODE_DETAILS());
+
+        tresult.assert_exception<std::runtime_error>([&]() {
+            std::vector<atom_string_t> unordered{ "b"_astr, "a"_astr };
+            auto join = src::leapfrog_join(tries[0], src::of_container(std::move(unordered)));
+            for (const auto& k : join)
+                tresult.debug() << k.size();
+            });
+    }
+
+    void test_TrieEraseRange(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = counted_trie_t;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr);
+        std::map<atom_string_t, double> standard;
+        auto insert = [&](const std::string& str, double v) {
+            atom_string_t key(str.begin(), str.end());
+            if (trie->insert(key, v).second)
+                standard.emplace(key, v);
+        };
+        //time-bucketed keys
+        for (int day = 1; day <= 28; ++day)
+            for (int event = 0; event < 30; ++event)
+            {
+                char buf[32];
+                std::snprintf(buf, sizeof(buf), "2024-02-%02d/evt%03d", day, event * 7);
+                insert(buf, day * 100. + event);
+            }
+        for (size_t i = 0; i < 1500; ++i)
+        {
+            auto key = random_key(tresult, 6, 'd');
+            insert(std::string(key.begin(), key.end()), static_cast<double>(i));
+        }
+
+        auto check_range = [&](const atom_string_t& from, const atom_string_t& to) {
+            auto lo = standard.lower_bound(from), hi = to < from ? lo : standard.lower_bound(to);
+            const auto expected = static_cast<std::uint64_t>(std::distance(lo, hi));
+            tresult.assert_that<equals>(expected, trie->count_range(from, to), OP_CODE_DETAILS());
+            const auto nodes_before = trie->nodes_count();
+            tresult.assert_that<equals>(expected, trie->erase_range(from, to), OP_CODE_DETAILS());
+            standard.erase(lo, hi);
+            tresult.assert_that<equals>(standard.size(), trie->size(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(0, trie->count_range(from, to), OP_CODE_DETAILS());
+            tresult.assert_true(trie->nodes_count() <= nodes_before, OP_CODE_DETAILS());
+            compare_containers(tresult, *trie, standard);
+            //subtree counters stay consistent
+            tresult.assert_that<equals>(standard.size(), trie->count_prefix(atom_string_t{}), OP_CODE_DETAILS());
+            for (const auto& probe : { "a"_astr, "ab"_astr, "b"_astr, "cd"_astr, "d"_astr, "2024-02-1"_astr })
+            {
+                auto plo = standard.lower_bound(probe);
+                auto phi = plo;
+                while (phi != standard.end() && phi->first.compare(0, probe.size(), probe) == 0)
+                    ++phi;
+                tresult.assert_that<equals>(static_cast<std::uint64_t>(std::distance(plo, phi)),
+                    trie->count_prefix(probe), OP_CODE_DETAILS());
+            }
+        };
+        const auto nodes_before = trie->nodes_count();
+        //whole buckets
+        check_range("2024-02-03"_astr, "2024-02-10"_astr);
+        //boundaries inside bucket, existing and absent keys
+        check_range("2024-02-10/evt014"_astr, "2024-02-11/evt100"_astr);
+        check_range("2024-02-20/evt0"_astr, "2024-02-20/evt1"_astr);
+        //prefix relations between boundaries and keys
+        check_range("ab"_astr, "abc"_astr);
+        check_range("b"_astr, "bb"_astr);
+        check_range("ca"_astr, "cad"_astr);
+        check_range("dddd"_astr, "dddd\xff"_astr);
+        //empty and inverted intervals
+        check_range("c"_astr, "c"_astr);
+        check_range("d"_astr, "c"_astr);
+        //from the very beginning
+        check_range(atom_string_t{}, "aab"_astr);
+        tresult.assert_that<less>(trie->nodes_count(), nodes_before, OP_CODE_DETAILS());
+        //random boundaries
+        for (size_t i = 0; i < 40; ++i)
+        {
+            auto from = random_key(tresult, 6, 'd');
+            auto to = from;
+            to.back() = static_cast<atom_t>(to.back() + 1 + i % 2);
+            if (i % 3 == 0)
+                to += random_key(tresult, 1, 'd');
+            check_range(from, to);
+        }
+
+        //released nodes are reused
+        for (size_t i = 0; i < 200; ++i)
+        {
+            char buf[32];
+            std::snprintf(buf, sizeof(buf), "2024-02-05/evt%03d", static_cast<int>(i));
+            insert(buf, static_cast<double>(i));
+        }
+        compare_containers(tresult, *trie, standard);
+        //everything
+        check_range(atom_string_t{}, "\xff"_astr);
+        tresult.assert_that<equals>(0, trie->size(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(1, trie->nodes_count(), OP_CODE_DETAILS());
+        insert("x", 1.);
+        compare_containers(tresult, *trie, standard);
+    }
+
+    void test_TrieMerge(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = counted_trie_t;
+        auto main_trie = make_trie<trie_t>(mem_change_history, test_file_name);
+        auto delta = make_trie<trie_t>(mem_change_history, "trie-delta.test");
+        std::map<atom_string_t, double> main_standard, delta_standard;
+
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            auto key = random_key(tresult, 8, 'e');
+            if (main_trie->insert(key, static_cast<double>(i)).second)
+                main_standard.emplace(key, static_cast<double>(i));
+        }
+        for (size_t i = 0; i < 600; ++i)
+        {
+            auto key = random_key(tresult, 8, 'e');
+            if (delta->insert(key, -static_cast<double>(i)).second)
+                delta_standard.emplace(key, -static_cast<double>(i));
+        }
+        //subtrees absent in the main trie, long stems split on both sides
+        for (const auto& key : { "zzz1"_astr, "zzz2"_astr, "zzz2/x"_astr, "ab-long-stem-1"_astr, "ab-long-stem-2"_astr, "ab-long"_astr })
+        {
+            delta->insert(key, 0.5);
+            delta_standard.emplace(key, 0.5);
+        }
+        for (const auto& key : { "ab-long-stem-0"_astr, "ab-long-xyz"_astr })
+        {
+            main_trie->insert(key, 0.25);
+            main_standard.emplace(key, 0.25);
+        }
+
+        std::uint64_t expected_added = 0, expected_conflicts = 0;
+        auto expected = main_standard;
+        for (const auto& [key, value] : delta_standard)
+        {
+            auto [pos, success] = expected.emplace(key, value);
+            if (success)
+                ++expected_added;
+            else
+            {
+                pos->second = value; //merge_policy::take_source
+                ++expected_conflicts;
+            }
+        }
+        auto report = main_trie->merge_from(*delta);
+        tresult.assert_that<equals>(expected_added, report._added, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(expected_conflicts, report._conflicts, OP_CODE_DETAILS());
+        tresult.assert_that<less>(0, report._grafted_nodes, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(expected.size(), main_trie->size(), OP_CODE_DETAILS());
+        compare_containers(tresult, *main_trie, expected);
+        tresult.assert_that<equals>(expected.size(), main_trie->count_prefix(atom_string_t{}), OP_CODE_DETAILS());
+        for (const auto& probe : { "a"_astr, "ab-long"_astr, "ab-long-stem-"_astr, "cd"_astr, "zzz2"_astr })
+        {
+            std::uint64_t n = 0;
+            for (auto i = expected.lower_bound(probe); i != expected.end() && i->first.compare(0, probe.size(), probe) == 0; ++i)
+                ++n;
+            tresult.assert_that<equals>(n, main_trie->count_prefix(probe), OP_CODE_DETAILS());
+        }
+        for (const auto& [key, value] : delta_standard) //membership filter knows grafted keys
+            tresult.assert_true(main_trie->check_exists(key), OP_CODE_DETAILS());
+        //source is untouched
+        compare_containers(tresult, *delta, delta_standard);
+
+        //merge again with custom resolver, nothing is added
+        report = main_trie->merge_from(*delta, [](double target, double source) { return target + source; });
+        tresult.assert_that<equals>(0, report._added, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(delta_standard.size(), report._conflicts, OP_CODE_DETAILS());
+        for (const auto& [key, value] : delta_standard)
+            expected[key] += value;
+        compare_containers(tresult, *main_trie, expected);
+
+        //merged trie stays fully functional
+        main_trie->erase_range("b"_astr, "d"_astr);
+        expected.erase(expected.lower_bound("b"_astr), expected.lower_bound("d"_astr));
+        tresult.assert_true(main_trie->insert("zzz2/y"_astr, 1.).second, OP_CODE_DETAILS());
+        expected.emplace("zzz2/y"_astr, 1.);
+        compare_containers(tresult, *main_trie, expected);
+
+        //keep_target into empty trie is just a copy
+        auto copy = make_trie<trie_t>(mem_change_history, "trie-merge-copy.test");
+        report = copy->merge_from(*main_trie, merge_policy::keep_target{});
+        tresult.assert_that<equals>(expected.size(), report._added, OP_CODE_DETAILS());
+        compare_containers(tresult, *copy, expected);
+
+        //resolver that throws mid-merge rolls back already grafted nodes together with counters
+        delta->insert("0-grafted-before-throw"_astr, 1.);
+        tresult.assert_exception<std::runtime_error>([&]() {
+            main_trie->merge_from(*delta, [](double, double) -> double { throw std::runtime_error("resolver failed"); });
+            });
+        tresult.assert_that<equals>(expected.size(), main_trie->size(), OP_CODE_DETAILS());
+        tresult.assert_true(main_trie->find("0-grafted-before-throw"_astr).is_end(), OP_CODE_DETAILS());
+        compare_containers(tresult, *main_trie, expected);
+
+        tresult.assert_exception<std::invalid_argument>([&]() {
+            main_trie->merge_from(*main_trie);
+            });
+    }
+
+    void test_TrieChangeFeed(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = test_trie_t;
+        const char* log_file_name = "trie-cdc.a0l";
+        std::filesystem::remove(log_file_name); //AppendOnlyLog::create_new doesn't override existing file
+        OP::utils::ThreadPool thread_pool;
+        auto log = OP::vtm::AppendOnlyLog::create_new(thread_pool, log_file_name);
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto primary = trie_t::create_new(tmngr);
+        auto replica = make_trie<trie_t>(mem_change_history, "trie-replica.test");
+        primary->change_feed(std::make_shared<ChangeFeed>(log));
+        trie_t::change_reader_t reader(log);
+        std::map<atom_string_t, double> standard;
+
+        for (size_t i = 0; i < 300; ++i)
+        {
+            auto key = random_key(tresult, 6, 'd');
+            if (primary->insert(key, static_cast<double>(i)).second)
+                standard.emplace(key, static_cast<double>(i));
+        }
+        //failed insert produces no record
+        tresult.assert_false(primary->insert(standard.begin()->first, -1.).second, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(standard.size(), reader.apply_to(*replica), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(primary->version(), reader.last_version(), OP_CODE_DETAILS());
+        compare_containers(tresult, *replica, standard);
+        //nothing new in the log
+        tresult.assert_that<equals>(0, reader.apply_to(*replica), OP_CODE_DETAILS());
+
+        //tail the feed while primary keeps changing
+        auto update_pos = primary->find("ab"_astr);
+        if (update_pos.is_end())
+            update_pos = primary->insert("ab"_astr, 0.).first;
+        primary->update(update_pos, 57.);
+        standard["ab"_astr] = 57.;
+        primary->upsert("ddddddd"_astr, 1.5);
+        standard["ddddddd"_astr] = 1.5;
+        primary->erase(primary->find("ab"_astr));
+        standard.erase("ab"_astr);
+        auto prefix = primary->find("c"_astr);
+        if (prefix.is_end())
+            prefix = primary->insert("c"_astr, 0.).first;
+        primary->prefixed_erase_all(prefix, false);
+        standard.erase(standard.upper_bound("c"_astr), standard.lower_bound("d"_astr));
+        standard["c"_astr] = primary->find("c"_astr).value();
+        primary->erase_range("b"_astr, "bc"_astr);
+        standard.erase(standard.lower_bound("b"_astr), standard.lower_bound("bc"_astr));
+        auto batch = primary->batch();
+        batch.insert("batch1"_astr, 1.).upsert("ddddddd"_astr, 2.).erase("a"_astr);
+        batch.apply();
+        standard.emplace("batch1"_astr, 1.);
+        standard["ddddddd"_astr] = 2.;
+        standard.erase("a"_astr);
+
+        std::vector<ChangeKind> kinds;
+        std::uint64_t previous_version = reader.last_version();
+        bool ordered = true;
+        reader.changes() >>= OP::flur::apply::for_each([&](const trie_t::change_record_t& record) {
+            ordered = ordered && previous_version <= record._version;
+            previous_version = record._version;
+            kinds.push_back(record._kind);
+            apply_change(*replica, record);
+            });
+        tresult.assert_true(ordered, "records must be ordered by version");
+        tresult.assert_that<equals>(ChangeKind::update, kinds.front(), OP_CODE_DETAILS());
+        tresult.assert_true(std::find(kinds.begin(), kinds.end(), ChangeKind::prefixed_erase_all) != kinds.end(), OP_CODE_DETAILS());
+        tresult.assert_true(std::find(kinds.begin(), kinds.end(), ChangeKind::erase_range) != kinds.end(), OP_CODE_DETAILS());
+        compare_containers(tresult, *primary, standard);
+        compare_containers(tresult, *replica, standard);
+        //range continues from the last consumed record
+        tresult.assert_that<equals>(0, reader.changes() >>= OP::flur::apply::count(), OP_CODE_DETAILS());
+
+        //replaying whole log from the start is idempotent, position allows to resume
+        trie_t::change_reader_t replay(log);
+        replay.apply_to(*replica);
+        compare_containers(tresult, *replica, standard);
+        tresult.assert_true(replay.position() == reader.position(), OP_CODE_DETAILS());
+
+        //records of outer user transaction appear only at its commit, rollback drops them
+        {
+            OP::vtm::TransactionGuard g(tmngr->begin_transaction());
+            primary->insert("rolled-back"_astr, 1.);
+            primary->upsert("ddddddd"_astr, 3.);
+        }
+        tresult.assert_that<equals>(0, reader.apply_to(*replica), OP_CODE_DETAILS());
+        {
+            OP::vtm::TransactionGuard g(tmngr->begin_transaction());
+            primary->insert("committed"_astr, 1.);
+            primary->upsert("ddddddd"_astr, 3.);
+            tresult.assert_that<equals>(0, reader.apply_to(*replica), OP_CODE_DETAILS());
+            g.commit();
+        }
+        standard.emplace("committed"_astr, 1.);
+        standard["ddddddd"_astr] = 3.;
+        tresult.assert_that<equals>(2, reader.apply_to(*replica), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(primary->version(), reader.last_version(), OP_CODE_DETAILS());
+        compare_containers(tresult, *primary, standard);
+        compare_containers(tresult, *replica, standard);
+
+        //record that doesn't fit segment of the log fails the operation before commit
+        const atom_string_t huge_key(log->max_allocation_size() + 1, 'h');
+        const auto size_before = primary->size();
+        tresult.assert_exception<std::length_error>([&]() { primary->insert(huge_key, 1.); });
+        tresult.assert_true(primary->find(huge_key).is_end(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(size_before, primary->size(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, reader.apply_to(*replica), OP_CODE_DETAILS());
+        compare_containers(tresult, *primary, standard);
+
+        //detached feed stops capturing
+        primary->change_feed(nullptr);
+        primary->insert("zzz"_astr, 1.);
+        tresult.assert_that<equals>(0, reader.apply_to(*replica), OP_CODE_DETAILS());
+    }
+
     void test_insert_10k(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
     {
         std::shared_ptr<EventSourcingSegmentManager> tmngr(
@@ -1814,6 +3044,295 @@ namespace
     }
 
 
+    void test_TrieTtl(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = Trie<EventSourcingSegmentManager,
+            PlainExpiringValueManager<double>, OP::common::atom_string_t>;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto trie = trie_t::create_new(tmngr);
+        const char* log_file_name = "trie-ttl.a0l";
+        std::filesystem::remove(log_file_name); //AppendOnlyLog::create_new doesn't override existing file
+        OP::utils::ThreadPool thread_pool;
+        auto log = OP::vtm::AppendOnlyLog::create_new(thread_pool, log_file_name);
+        auto [index_address, index] = ExpiryIndex::create_new(log);
+        TtlSweeper<trie_t> sweeper(trie, index);
+
+        std::map<atom_string_t, double> standard;
+        std::map<atom_string_t, expiry_t> expiry;
+        for (size_t i = 0; i < 400; ++i)
+        {
+            auto key = random_key(tresult, 6, 'e');
+            auto [pos, success] = trie->insert(key, static_cast<double>(i));
+            if (!success)
+                continue;
+            standard.emplace(key, static_cast<double>(i));
+            tresult.assert_that<equals>(never_expire_c, trie->expiry_of(pos), OP_CODE_DETAILS());
+            if (i % 3 == 0)
+            {
+                const expiry_t at = 100 + (i % 50);
+                tresult.assert_true(sweeper.expire(pos, at), OP_CODE_DETAILS());
+                expiry[key] = at;
+            }
+        }
+        tresult.assert_false(expiry.empty(), OP_CODE_DETAILS());
+        //lookup hides expired keys before the sweeper reaches them
+        for (const auto& [key, at] : expiry)
+        {
+            tresult.assert_false(trie->find(key).is_end(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(at <= 120, trie->find_alive(key, 120).is_end(), OP_CODE_DETAILS());
+        }
+        //update keeps expiration, new expiration overrides indexed one
+        auto updated = expiry.begin();
+        auto pos = trie->find(updated->first);
+        trie->update(pos, -1.);
+        standard[updated->first] = -1.;
+        tresult.assert_that<equals>(updated->second, trie->expiry_of(pos), OP_CODE_DETAILS());
+        auto prolonged = std::next(updated);
+        pos = trie->find(prolonged->first);
+        tresult.assert_true(trie->expire(pos, never_expire_c), OP_CODE_DETAILS());
+        expiry.erase(prolonged);
+        //key erased explicitly leaves stale record in the index
+        auto erased = std::next(expiry.begin());
+        trie->erase(trie->find(erased->first));
+        standard.erase(erased->first);
+        expiry.erase(erased);
+
+        auto sweep_to = [&](expiry_t now) {
+            size_t erased_count = 0, batches = 0;
+            for (auto report = SweepReport{ 0, 0, false }; !report._complete; ++batches)
+            {
+                report = sweeper.sweep(now, 8);
+                tresult.assert_that<less_or_equals>(report._erased, 8, OP_CODE_DETAILS());
+                erased_count += report._erased;
+            }
+            for (auto i = expiry.begin(); i != expiry.end(); )
+            {
+                if (i->second <= now)
+                {
+                    standard.erase(i->first);
+                    i = expiry.erase(i);
+                }
+                else
+                    ++i;
+            }
+            compare_containers(tresult, *trie, standard);
+            return std::make_pair(erased_count, batches);
+        };
+        const auto before = standard.size();
+        auto [erased_count, batches] = sweep_to(120);
+        tresult.assert_that<equals>(before - standard.size(), erased_count, OP_CODE_DETAILS());
+        tresult.assert_that<greater>(batches, 1, "sweep must be split to batches");
+        //nothing new to sweep
+        tresult.assert_that<equals>(0, sweeper.sweep(120)._checked, OP_CODE_DETAILS());
+        sweep_to(1000);
+        tresult.assert_true(expiry.empty(), OP_CODE_DETAILS());
+        //expiration point behind already swept one is picked by the next pass
+        pos = trie->find(standard.begin()->first);
+        tresult.assert_true(sweeper.expire(pos, 500), OP_CODE_DETAILS());
+        expiry[standard.begin()->first] = 500;
+        tresult.assert_that<equals>(1, sweep_to(1001).first, OP_CODE_DETAILS());
+        //index survives reopen
+        auto reopened = ExpiryIndex::open(log, index_address);
+        size_t indexed = 0;
+        reopened->for_each_due<atom_string_t>(ExpiryQuery{ never_expire_c, 1000 }, [&](atom_string_t&&, expiry_t) {
+            return ++indexed, true;
+            });
+        tresult.assert_that<greater>(indexed, 0, OP_CODE_DETAILS());
+        //progress survives reopen as well, so swept records are not checked again
+        tresult.assert_that<equals>(1001, reopened->swept(), OP_CODE_DETAILS());
+        TtlSweeper<trie_t> resumed(trie, reopened);
+        tresult.assert_that<equals>(0, resumed.sweep(1001)._checked, OP_CODE_DETAILS());
+
+        //background sweeping
+        pos = trie->find(standard.begin()->first);
+        sweeper.expire(pos, ExpiryClock::now());
+        sweeper.start(thread_pool, std::chrono::milliseconds(5));
+        tresult.assert_exception<std::logic_error>([&]() { sweeper.start(thread_pool, std::chrono::milliseconds(5)); });
+        for (size_t attempt = 0; attempt < 400 && !trie->find(standard.begin()->first).is_end(); ++attempt)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        sweeper.stop();
+        standard.erase(standard.begin());
+        compare_containers(tresult, *trie, standard);
+    }
+
+    void test_TrieBlobValue(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = Trie<EventSourcingSegmentManager, BlobValueManager<>, OP::common::atom_string_t>;
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto trie = trie_t::create_new(tmngr);
+        auto random_text = [&](size_t size) {
+            std::string result;
+            return tresult.randomizer().random_str(result, size, size, [](size_t rnd) {
+                return static_cast<char>('0' + rnd % ('z' - '0' + 1));
+                });
+        };
+        auto join_chunks = [&](const trie_t::iterator& pos) {
+            std::string result;
+            size_t chunks = 0;
+            trie->value_chunks(pos) >>= OP::flur::apply::for_each([&](const ReadonlyMemoryChunk& chunk) {
+                result.append(chunk.begin(), chunk.end());
+                ++chunks;
+                });
+            return std::make_pair(result, chunks);
+        };
+        std::map<atom_string_t, std::string> standard;
+        //value bigger than segment is split across segments
+        const auto huge = random_text(3 * 0x110000 + 17);
+        auto [huge_pos, success] = trie->insert("huge"_astr, huge);
+        tresult.assert_true(success, OP_CODE_DETAILS());
+        standard.emplace("huge"_astr, huge);
+        auto [huge_read, huge_chunks] = join_chunks(huge_pos);
+        tresult.assert_true(huge == huge_read, OP_CODE_DETAILS());
+        tresult.assert_that<greater>(huge_chunks, 3, OP_CODE_DETAILS());
+        tresult.assert_true(huge == trie->find("huge"_astr).value(), OP_CODE_DETAILS());
+
+        //small values and empty value
+        for (size_t i = 0; i < 50; ++i)
+        {
+            const auto suffix = std::to_string(i);
+            atom_string_t key = "k"_astr;
+            key.append(suffix.begin(), suffix.end());
+            auto text = random_text(i * 7);
+            trie->insert(key, text);
+            standard.emplace(key, text);
+        }
+        tresult.assert_true(trie->find("k0"_astr).value().empty(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(0, join_chunks(trie->find("k0"_astr)).second, OP_CODE_DETAILS());
+        compare_containers(tresult, *trie, standard);
+
+        //appending writes extend tail chunk in place
+        auto pos = trie->find("k3"_astr);
+        for (size_t i = 0; i < 200; ++i)
+        {
+            auto text = random_text(i % 13 + 1);
+            tresult.assert_that<equals>(1, trie->append_value(pos, text), OP_CODE_DETAILS());
+            standard["k3"_astr] += text;
+        }
+        auto [appended, appended_chunks] = join_chunks(pos);
+        tresult.assert_true(standard["k3"_astr] == appended, OP_CODE_DETAILS());
+        tresult.assert_that<less>(appended_chunks, 10, "appends must not produce chunk per call");
+        trie->append_value(huge_pos, std::string("tail"));
+        standard["huge"_astr] += "tail";
+
+        //update and erase release chunks, so space is reused
+        trie->update(huge_pos, "small now");
+        standard["huge"_astr] = "small now";
+        trie->erase(trie->find("k10"_astr));
+        standard.erase("k10"_astr);
+        compare_containers(tresult, *trie, standard);
+        auto end_pos = trie->end();
+        tresult.assert_that<equals>(0, trie->append_value(end_pos, std::string("x")), OP_CODE_DETAILS());
+
+        //change feed captures only appended bytes, replaying the record twice appends them once
+        const char* log_file_name = "trie-blob-cdc.a0l";
+        std::filesystem::remove(log_file_name); //AppendOnlyLog::create_new doesn't override existing file
+        OP::utils::ThreadPool thread_pool;
+        auto log = OP::vtm::AppendOnlyLog::create_new(thread_pool, log_file_name);
+        trie->change_feed(std::make_shared<ChangeFeed>(log));
+        const auto before_append = standard["k3"_astr];
+        tresult.assert_that<equals>(before_append.size(), trie->value_size(pos), OP_CODE_DETAILS());
+        trie->append_value(pos, std::string("delta"));
+        standard["k3"_astr] += "delta";
+        trie->change_feed(nullptr);
+        std::vector<trie_t::change_record_t> records;
+        trie_t::change_reader_t reader(log);
+        reader.changes() >>= OP::flur::apply::for_each([&](const trie_t::change_record_t& record) {
+            records.push_back(record);
+            });
+        tresult.assert_that<equals>(1, records.size(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(ChangeKind::append, records.front()._kind, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(std::string("delta"), *records.front()._value, OP_CODE_DETAILS());
+        tresult.assert_that<equals>(before_append.size(), records.front()._offset, OP_CODE_DETAILS());
+        auto replica = make_trie<trie_t>(mem_change_history, "trie-replica.test");
+        replica->insert("k3"_astr, before_append);
+        apply_change(*replica, records.front());
+        apply_change(*replica, records.front());
+        tresult.assert_true(standard["k3"_astr] == replica->find("k3"_astr).value(), OP_CODE_DETAILS());
+        tresult.assert_exception<std::invalid_argument>([&]() { trie->value_chunks(trie->end()); });
+    }
+
+    void test_TrieCompressedValue(OP::utest::TestRuntime& tresult, std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        using trie_t = Trie<EventSourcingSegmentManager, CompressedValueManager, OP::common::atom_string_t>;
+        const std::array<const char*, 4> statuses{ "active", "suspended", "pending", "archived" };
+        auto make_record = [&](size_t i) {
+            return std::string("{\"id\":") + std::to_string(i)
+                + ",\"type\":\"customer\",\"status\":\"" + statuses[i % statuses.size()]
+                + "\",\"balance\":" + std::to_string(tresult.randomizer().next_in_range(0, 100000))
+                + ",\"address\":{\"country\":\"US\",\"city\":\"Springfield\",\"zip\":\"" + std::to_string(tresult.randomizer().next_in_range(0, 100000))
+                + "\"},\"tags\":[\"retail\",\"newsletter\"],\"created\":\"2024-01-" + std::to_string(10 + i % 20) + "T00:00:00Z\"}";
+        };
+        std::vector<std::string> samples;
+        for (size_t i = 0; i < 300; ++i)
+            samples.push_back(make_record(i));
+
+        //codec itself: dictionary gives big savings even for single small record
+        const DictionaryLz::Index index(CompressionDictionary::build(samples));
+        tresult.assert_false(index._bytes.empty(), OP_CODE_DETAILS());
+        size_t raw_total = 0, compressed_total = 0;
+        for (size_t i = 1000; i < 1100; ++i)
+        {
+            const auto record = make_record(i);
+            std::string encoded;
+            DictionaryLz::compress(index, record.data(), record.size(), encoded);
+            raw_total += record.size();
+            compressed_total += encoded.size();
+            tresult.assert_true(record == DictionaryLz::decompress(index._bytes,
+                reinterpret_cast<const std::uint8_t*>(encoded.data()), encoded.size(), record.size()), OP_CODE_DETAILS());
+        }
+        tresult.info() << "compression ratio:" << (double)raw_total / compressed_total << "\n";
+        tresult.assert_that<greater>(2 * raw_total, 5 * compressed_total, "expected at least 2.5x savings");
+        const std::string periodic(1000, 'z');
+        std::string encoded;
+        DictionaryLz::compress(DictionaryLz::Index{}, periodic.data(), periodic.size(), encoded);
+        tresult.assert_that<less>(encoded.size(), 20, OP_CODE_DETAILS());
+        tresult.assert_true(periodic == DictionaryLz::decompress({},
+            reinterpret_cast<const std::uint8_t*>(encoded.data()), encoded.size(), periodic.size()), OP_CODE_DETAILS());
+        tresult.assert_exception<std::runtime_error>([&]() {
+            DictionaryLz::decompress({}, reinterpret_cast<const std::uint8_t*>(encoded.data()), encoded.size() - 1, periodic.size());
+            });
+
+        std::shared_ptr<EventSourcingSegmentManager> tmngr(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        auto trie = trie_t::create_new(tmngr);
+        std::map<atom_string_t, std::string> standard;
+        auto add = [&](size_t i, std::string value) {
+            const auto id = std::to_string(i);
+            atom_string_t key(id.begin(), id.end());
+            trie->insert(key, value);
+            standard.emplace(std::move(key), std::move(value));
+        };
+        //values inserted before training stay readable
+        for (size_t i = 0; i < 50; ++i)
+            add(i, samples[i]);
+        add(50, std::string{});
+        trie->train_compression(samples);
+        tresult.assert_exception<std::logic_error>([&]() { trie->train_compression(samples); });
+        for (size_t i = 51; i < 500; ++i)
+            add(i, make_record(i));
+        compare_containers(tresult, *trie, standard);
+        auto pos = trie->find("7"_astr);
+        trie->update(pos, "{\"id\":7,\"type\":\"customer\"}");
+        standard["7"_astr] = "{\"id\":7,\"type\":\"customer\"}";
+        trie->erase(trie->find("100"_astr));
+        standard.erase("100"_astr);
+        compare_containers(tresult, *trie, standard);
+    }
+
     static auto& module_suite = OP::utest::default_test_suite("Trie.core")
         .declare("creation", test_TrieCreation)
         .declare("insertion", test_TrieInsert)
@@ -1840,6 +3359,22 @@ namespace
         .declare("next_lower_bound", test_NextLowerBound)
         .declare("issue_erase_seq_of_4", issue_erase_seq_of_4)
         .declare("issue_next_sibling", issue_next_sibling)
+        .declare("bulk_load", test_TrieBulkLoad)
+        .declare("find_many", test_TrieFindMany)
+        .declare("adaptive-node", test_TrieAdaptiveNode)
+        .declare("snapshot", test_TrieSnapshot)
+        .declare("subtree-count", test_TrieSubtreeCount)
+        .declare("batch", test_TrieBatch)
+        .declare("membership-filter", test_TrieMembershipFilter)
+        .declare("compaction", test_TrieCompaction)
+        .declare("minimize", test_TrieMinimize)
+        .declare("leapfrog-join", test_TrieLeapfrogJoin)
+        .declare("erase-range", test_TrieEraseRange)
+        .declare("merge", test_TrieMerge)
+        .declare("change-feed", test_TrieChangeFeed)
+        .declare("ttl", test_TrieTtl)
+        .declare("blob-value", test_TrieBlobValue)
+        .declare("compressed-value", test_TrieCompressedValue)
         .declare_disabled("insert-10k", test_insert_10k)
 
         // define scenario parameter with InMemory implementation
@@ -6,6 +6,7 @@
 #include <op/utest/unit_test_is.h>
 
 #include <op/flur/flur.h>
+#include <op/common/ThreadPool.h>
 
 #include <op/trie/Trie.h>
 #include <op/trie/PlainValueManager.h>
@@ -19,6 +20,7 @@
 #include <op/vtm/managers/BaseSegmentManager.h>
 
 #include <algorithm>
+#include <thread>
 #include "../test_comparators.h"
 #include "../vtm/MemoryChangeHistoryFixture.h"
 
@@ -149,6 +151,94 @@ namespace
         }
     }
 
+    void test_ReverseRange(OP::utest::TestRuntime& tresult, 
+        std::shared_ptr<test::ChangeHistoryFactory> history_factory)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                history_factory->create()
+            ));
+
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr1);
+        //empty trie
+        tresult.assert_true(trie->last().is_end());
+        tresult.assert_true(trie->rbegin().is_end());
+        tresult.assert_that<equals>(0, (trie->reverse_prefixed_range("a"_astr) >>= apply::count()));
+
+        std::map<atom_string_t, double> test_values;
+        const atom_string_t stems[] = { "abc"_astr, "x"_astr, atom_string_t(256, 'z') };
+        for (unsigned i = 0; i < 255; i += 3)
+        {
+            atom_string_t root(1, (atom_t)i);
+            if ((i & 1) != 0) //for odd entries make terminal
+                test_values.emplace(root, i);
+            for (const auto& j : stems)
+            {
+                test_values.emplace(root + j, j.size());
+                test_values.emplace(root + j + j, j.size() * 2);
+            }
+        }
+        test_values.emplace("abcabd"_astr, 1.);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+
+        //full backward scan
+        auto expected = test_values.rbegin();
+        size_t cnt = 0;
+        for (auto i = trie->rbegin(); trie->in_range(i); trie->prev(i), ++expected, ++cnt)
+        {
+            tresult.assert_that<equals>(expected->first, i.key(), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(expected->second, i.value(), OP_CODE_DETAILS());
+        }
+        tresult.assert_that<equals>(test_values.size(), cnt, OP_CODE_DETAILS());
+
+        //operator-- from end() and round-trip with operator++
+        auto pos = trie->end();
+        --pos;
+        tresult.assert_that<equals>(test_values.rbegin()->first, pos.key(), OP_CODE_DETAILS());
+        for (auto i = trie->begin(); trie->in_range(i); ++i)
+        {
+            auto back = i;
+            ++back;
+            if (!trie->in_range(back))
+                break;
+            --back;
+            tresult.assert_that<equals>(i.key(), back.key(), OP_CODE_DETAILS());
+        }
+        auto first = trie->begin();
+        --first;
+        tresult.assert_true(first.is_end(), OP_CODE_DETAILS());
+
+        //reverse prefixed ranges
+        for (auto prefix : { "a"_astr, "ab"_astr, "abc"_astr, "abcabc"_astr, 
+            atom_string_t(1, (atom_t)3), atom_string_t(1, (atom_t)4), atom_string_t(1, (atom_t)9) + "z"_astr})
+        {
+            std::vector<atom_string_t> expected_keys;
+            for (auto i = test_values.lower_bound(prefix); 
+                i != test_values.end() && i->first.compare(0, prefix.size(), prefix) == 0; ++i)
+                expected_keys.push_back(i->first);
+            std::reverse(expected_keys.begin(), expected_keys.end());
+            
+            std::vector<atom_string_t> actual;
+            for (const auto& i : trie->reverse_prefixed_range(prefix))
+                actual.push_back(i.key());
+            tresult.assert_that<eq_sets>(expected_keys, actual, OP_CODE_DETAILS());
+            //top-k
+            std::vector<atom_string_t> top2;
+            for (const auto& i : trie->reverse_prefixed_range(prefix))
+            {
+                if (top2.size() == 2)
+                    break;
+                top2.push_back(i.key());
+            }
+            expected_keys.resize(std::min<size_t>(2, expected_keys.size()));
+            tresult.assert_that<eq_sets>(expected_keys, top2, OP_CODE_DETAILS());
+        }
+    }
+
     template <class R1, class R2, class Sample>
     void test_join(
         OP::utest::TestRuntime& tresult, R1 r1, R2 r2, const Sample& expected)
@@ -1178,6 +1268,271 @@ namespace
         }
     }
 
+    void test_ParallelRange(OP::utest::TestRuntime& tresult,
+        std::shared_ptr<test::ChangeHistoryFactory> history_factory)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                history_factory->create()
+            ));
+
+        using trie_t = test_trie_t;
+        using entries_t = std::vector<std::pair<atom_string_t, double>>;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr1);
+        OP::utils::ThreadPool pool;
+        const auto main_thread = std::this_thread::get_id();
+        //each partition is consumed on the worker and only collected entries are passed back
+        auto collect = [&](const auto& partition) {
+            tresult.assert_true(std::this_thread::get_id() != main_thread, OP_CODE_DETAILS());
+            entries_t result;
+            for (const auto& i : partition)
+                result.emplace_back(i.key(), i.value());
+            return result;
+        };
+        auto same_entry = [](const auto& left, const auto& right) {
+            return left.first == right.first && left.second == right.second; };
+        //empty trie
+        tresult.assert_that<equals>(1, trie->partitions(4).size());
+        for (const auto& part : trie->parallel_range(pool, 4, collect))
+            tresult.assert_true(part.empty(), OP_CODE_DETAILS());
+
+        std::map<atom_string_t, double> test_values;
+        auto check = [&](size_t fanout) {
+            auto bounds = trie->partition_bounds(fanout);
+            tresult.assert_true(bounds.size() < std::max<size_t>(fanout, 1), OP_CODE_DETAILS());
+            tresult.assert_true(std::is_sorted(bounds.begin(), bounds.end()), OP_CODE_DETAILS());
+            tresult.assert_that<equals>(bounds.size() + 1, trie->partitions(fanout).size(), OP_CODE_DETAILS());
+
+            entries_t ordered;
+            for (const auto& part : trie->parallel_range(pool, fanout, collect))
+                ordered.insert(ordered.end(), part.begin(), part.end());
+            tresult.assert_that<equals>(test_values.size(), ordered.size(), OP_CODE_DETAILS());
+            tresult.assert_true(std::equal(test_values.begin(), test_values.end(), ordered.begin(), ordered.end(),
+                same_entry), OP_CODE_DETAILS());
+
+            std::set<atom_string_t> unordered;
+            for (const auto& part : trie->parallel_unordered_range(pool, fanout, collect))
+                for (const auto& entry : part)
+                    tresult.assert_true(unordered.insert(entry.first).second, OP_CODE_DETAILS());
+            tresult.assert_that<equals>(test_values.size(), unordered.size(), OP_CODE_DETAILS());
+        };
+        //few root entries force split on the level-1
+        for (auto prefix : { "a"_astr, "abc"_astr, "b"_astr })
+            for (atom_t c = 0; c < 64; ++c)
+            {
+                atom_string_t key = prefix + atom_string_t(1, c);
+                test_values.emplace(key, c);
+                test_values.emplace(key + "tail"_astr, -c);
+            }
+        test_values.emplace("b"_astr, 1.);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+        for (size_t fanout : { 1, 2, 3, 8, 200 })
+            check(fanout);
+        tresult.assert_true(trie->partition_bounds(8).size() > 2, OP_CODE_DETAILS());
+
+        //wide root
+        for (unsigned i = 0; i < 255; i += 5)
+        {
+            atom_string_t key(1, static_cast<atom_t>(i));
+            test_values.emplace(key + "x"_astr, i);
+            trie->insert(key + "x"_astr, static_cast<double>(i));
+        }
+        for (size_t fanout : { 4, 16 })
+            check(fanout);
+
+        //lower_bound of the partition never goes below the interval
+        auto parts = trie->partitions(4);
+        tresult.assert_true(parts.size() > 1, OP_CODE_DETAILS());
+        auto second = parts[1].compound();
+        second.start();
+        second.lower_bound(trie->begin());
+        tresult.assert_true(second.in_range(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(trie->partition_bounds(4)[0], second.current().key(), OP_CODE_DETAILS());
+        //re-iteration of the same range
+        auto range = trie->parallel_range(pool, 4, [](const auto& partition) {
+            return partition >>= apply::count();
+            });
+        auto total = [](auto& results) {
+            size_t sum = 0;
+            for (auto n : results)
+                sum += n;
+            return sum;
+        };
+        tresult.assert_that<equals>(test_values.size(), total(range));
+        tresult.assert_that<equals>(test_values.size(), total(range));
+    }
+
+    void test_FuzzyRange(OP::utest::TestRuntime& tresult,
+        std::shared_ptr<test::ChangeHistoryFactory> history_factory)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                history_factory->create()
+            ));
+
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr1);
+        tresult.assert_that<equals>(0, (trie->fuzzy_range("abc"_astr, 2) >>= apply::count()));
+
+        auto distance = [](const atom_string_t& a, const atom_string_t& b) {
+            std::vector<size_t> prev(b.size() + 1), next(b.size() + 1);
+            for (size_t j = 0; j <= b.size(); ++j)
+                prev[j] = j;
+            for (size_t i = 1; i <= a.size(); ++i)
+            {
+                next[0] = i;
+                for (size_t j = 1; j <= b.size(); ++j)
+                    next[j] = std::min({ prev[j - 1] + (a[i - 1] == b[j - 1] ? 0 : 1), prev[j] + 1, next[j - 1] + 1 });
+                std::swap(prev, next);
+            }
+            return prev[b.size()];
+        };
+
+        std::map<atom_string_t, double> test_values;
+        std::mt19937 random_gen(0xf022);
+        std::uniform_int_distribution<int> len_dist(1, 8), char_dist('a', 'e');
+        for (size_t i = 0; i < 2000; ++i)
+        {
+            atom_string_t key;
+            for (auto len = len_dist(random_gen); len; --len)
+                key.push_back(static_cast<atom_t>(char_dist(random_gen)));
+            test_values.emplace(key, static_cast<double>(i));
+        }
+        //keys that exercise skip over 0xFF
+        test_values.emplace(atom_string_t(3, 0xFF), 1.);
+        test_values.emplace("a"_astr + atom_string_t(2, 0xFF), 2.);
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+        //skip of subtree relies on lower_bound of absent keys that diverge inside stem or node
+        for (auto probe : { "aaab"_astr, "aabbb"_astr, "aabca"_astr, "abedb"_astr, "cz"_astr, "e"_astr + atom_string_t(1, 0xFF) })
+        {
+            auto expected = test_values.lower_bound(probe);
+            auto actual = trie->lower_bound(probe);
+            tresult.assert_that<equals>(expected == test_values.end(), actual.is_end(), OP_CODE_DETAILS());
+            if (!actual.is_end())
+                tresult.assert_that<equals>(expected->first, actual.key(), OP_CODE_DETAILS());
+        }
+
+        for (auto query : { "abc"_astr, "a"_astr, "eeddcc"_astr, "abcdeabc"_astr, "zz"_astr, atom_string_t(2, 0xFF) })
+        {
+            for (size_t max_edits : { 0, 1, 2 })
+            {
+                std::vector<atom_string_t> expected;
+                for (const auto& [key, _] : test_values)
+                    if (distance(key, query) <= max_edits)
+                        expected.push_back(key);
+                std::vector<atom_string_t> actual;
+                for (const auto& i : trie->fuzzy_range(query, max_edits))
+                    actual.push_back(i.key());
+                tresult.assert_that<equals>(expected.size(), actual.size(), OP_CODE_DETAILS());
+                tresult.assert_true(expected == actual, OP_CODE_DETAILS());
+            }
+        }
+        //range is ordered, so it can be joined with other ordered ranges
+        auto fuzzy = trie->fuzzy_range("abc"_astr, 1);
+        auto prefixed = trie->prefixed_range("ab"_astr);
+        size_t expected_join = 0;
+        for (const auto& [key, _] : test_values)
+            if (key.size() >= 2 && key[0] == 'a' && key[1] == 'b' && distance(key, "abc"_astr) <= 1)
+                ++expected_join;
+        tresult.assert_that<equals>(expected_join, (fuzzy & prefixed) >>= apply::count(), OP_CODE_DETAILS());
+    }
+
+    /** Reference glob implementation for the test, supports `*`, `?` and `[a-z]` / `[!a-z]` */
+    bool glob_matches(const atom_string_t& pattern, size_t p, const atom_string_t& key, size_t k)
+    {
+        if (p == pattern.size())
+            return k == key.size();
+        if (pattern[p] == '*')
+            return glob_matches(pattern, p + 1, key, k) || (k < key.size() && glob_matches(pattern, p, key, k + 1));
+        if (k == key.size())
+            return false;
+        if (pattern[p] == '[')
+        {
+            size_t close = pattern.find(']', p + 2);
+            bool negate = pattern[p + 1] == '!';
+            bool in = false;
+            for (size_t i = p + 1 + (negate ? 1 : 0); i < close; ++i)
+            {
+                if (i + 2 < close && pattern[i + 1] == '-')
+                {
+                    in |= pattern[i] <= key[k] && key[k] <= pattern[i + 2];
+                    i += 2;
+                }
+                else
+                    in |= pattern[i] == key[k];
+            }
+            return in != negate && glob_matches(pattern, close + 1, key, k + 1);
+        }
+        return (pattern[p] == '?' || pattern[p] == key[k]) && glob_matches(pattern, p + 1, key, k + 1);
+    }
+
+    void test_MatchRange(OP::utest::TestRuntime& tresult,
+        std::shared_ptr<test::ChangeHistoryFactory> history_factory)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    test_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                history_factory->create()
+            ));
+
+        using trie_t = test_trie_t;
+        std::shared_ptr<trie_t> trie = trie_t::create_new(tmngr1);
+        tresult.assert_that<equals>(0, (trie->match_range("*"_astr) >>= apply::count()));
+
+        std::map<atom_string_t, double> test_values;
+        for (auto user : { "alice"_astr, "bob"_astr, "carol"_astr, "dave"_astr })
+            for (unsigned month = 1; month <= 12; ++month)
+                for (auto year : { "2025"_astr, "2026"_astr })
+                {
+                    atom_string_t suffix(1, static_cast<atom_t>('0' + month / 10));
+                    suffix += static_cast<atom_t>('0' + month % 10);
+                    test_values.emplace("user:"_astr + user + ":session:"_astr + year + "-"_astr + suffix, month);
+                    test_values.emplace("user:"_astr + user + ":profile:"_astr + year + suffix, month);
+                }
+        std::mt19937 random_gen(0x610b);
+        std::uniform_int_distribution<int> len_dist(1, 7), char_dist('a', 'e');
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            atom_string_t key;
+            for (auto len = len_dist(random_gen); len; --len)
+                key.push_back(static_cast<atom_t>(char_dist(random_gen)));
+            test_values.emplace(key, static_cast<double>(i));
+        }
+        for (const auto& [key, value] : test_values)
+            trie->insert(key, value);
+
+        for (auto pattern : { "user:*:session:2026-??"_astr, "user:[a-c]*:*:2025*"_astr, "*a*b"_astr,
+            "?"_astr, "[!a-d]?e*"_astr, "abc"_astr, "*"_astr, "user:bob*1"_astr, "zzz*"_astr, ""_astr })
+        {
+            std::vector<atom_string_t> expected;
+            for (const auto& [key, _] : test_values)
+                if (glob_matches(pattern, 0, key, 0))
+                    expected.push_back(key);
+            std::vector<atom_string_t> actual;
+            for (const auto& i : trie->match_range(pattern))
+                actual.push_back(i.key());
+            tresult.assert_that<equals>(expected.size(), actual.size(), OP_CODE_DETAILS());
+            tresult.assert_true(expected == actual, OP_CODE_DETAILS());
+        }
+        tresult.assert_that<equals>(48,
+            trie->match_range("user:*:session:2026-??"_astr) >>= apply::count(), OP_CODE_DETAILS());
+        //escape and literal special atoms
+        trie->insert("a*b"_astr, 1.);
+        trie->insert("a[b"_astr, 1.);
+        tresult.assert_that<equals>(1, trie->match_range("a\\*b"_astr) >>= apply::count(), OP_CODE_DETAILS());
+        tresult.assert_that<equals>(1, trie->match_range("a[[]b"_astr) >>= apply::count(), OP_CODE_DETAILS());
+
+        tresult.assert_exception<std::invalid_argument>([&]() { trie->match_range("ab[c"_astr); });
+        tresult.assert_exception<std::invalid_argument>([&]() { trie->match_range("ab\\"_astr); });
+    }
+
     static auto& module_suite = OP::utest::default_test_suite("Trie.range")
 
         .declare("subtree of prefix", test_TrieSubtree)
@@ -1191,6 +1546,10 @@ namespace
         .declare("override_join_range", test_JoinRangeOverride)
         .declare("ISSUE_0001", test_ISSUE_0001)
         .declare("10k", test_10k)
+        .declare("reverse", test_ReverseRange)
+        .declare("parallel", test_ParallelRange)
+        .declare("fuzzy", test_FuzzyRange)
+        .declare("match", test_MatchRange)
         .with_fixture(test::memory_change_history_factory<test::InMemoryChangeHistoryFactory>)
         //
         ;
@@ -1049,6 +1049,44 @@ namespace
         tresult.assert_that<equals>(ro_bx140_x100, test_seq2);
     }
 
+    void test_EvSrcCommitHandlers(OP::utest::TestRuntime& tresult, 
+        std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    "t-segmentation.test", OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+        tmngr1->ensure_segment(0);
+        std::vector<int> invoked;
+        auto handler = [&](int marker) {
+            return [&invoked, marker]() { invoked.push_back(marker); };
+        };
+
+        {
+            OP::vtm::TransactionGuard g(tmngr1->begin_transaction());
+            g.transaction()->on_commit(handler(1));
+        }
+        tresult.assert_true(invoked.empty(), "rollback must drop handlers");
+
+        {
+            OP::vtm::TransactionGuard g(tmngr1->begin_transaction());
+            g.transaction()->on_commit(handler(1));
+            {
+                OP::vtm::TransactionGuard nested(tmngr1->begin_transaction());
+                nested.transaction()->on_commit(handler(2));
+                nested.commit();
+            }
+            {
+                OP::vtm::TransactionGuard nested(tmngr1->begin_transaction());
+                nested.transaction()->on_commit(handler(3));
+            }
+            tresult.assert_true(invoked.empty(), "nested commit must pass handlers to outer transaction");
+            g.commit();
+        }
+        tresult.assert_that<equals>(invoked, std::vector<int>{1, 2}, OP_CODE_DETAILS());
+    }
 
     static auto& module_suite = OP::utest::default_test_suite("vtm.EventSourcingSegmentManager")
         .with_fixture(test::memory_change_history_factory<test::InMemoryChangeHistoryFactory>)
@@ -1063,5 +1101,6 @@ namespace
         .declare("test read-block include capability", test_EvSrcBlockIncludeOnRead)
         .declare("transaction on overlapped blocks", test_EvSrcBlockOverlapOnRead)
         .declare("ro-transaction", test_ROTransaction)
+        .declare("commit-handlers", test_EvSrcCommitHandlers)
         ;
 }
\ No newline at end of file
@@ -251,6 +251,24 @@ namespace
             OP_CODE_DETAILS(<< "All must be free"));
         tresult.assert_that<equals>(2 * test_nodes_count_c, usage.second,
             OP_CODE_DETAILS(<< "Free count must be:" << test_nodes_count_c));
+
+        //release all in a single batch
+        OP::vtm::TransactionGuard g_alloc(mngrToplogy.segment_manager().begin_transaction());
+        fmm.allocate_n(result, std::extent_v<decltype(result)>, [&](size_t, auto* p) {
+            return new (p) TestPayload{ generation };
+            });
+        g_alloc.commit();
+        tresult.assert_that<equals>(std::extent_v<decltype(result)>, fmm.usage_info().first, OP_CODE_DETAILS());
+        OP::vtm::TransactionGuard g_free(mngrToplogy.segment_manager().begin_transaction());
+        fmm.deallocate_n(result, std::extent_v<decltype(result)>);
+        fmm.deallocate_n(result, 0);
+        g_free.commit();
+        mngrToplogy._check_integrity(tresult.run_options().log_level() > ResultLevel::info);
+        usage = fmm.usage_info();
+        tresult.assert_that<equals>(0, usage.first,
+            OP_CODE_DETAILS(<< "All must be free"));
+        tresult.assert_that<equals>(2 * test_nodes_count_c, usage.second,
+            OP_CODE_DETAILS(<< "Free count must be:" << 2 * test_nodes_count_c));
     }
 
     void test_NodeManagerSmallPayload(OP::utest::TestRuntime& tresult,
@@ -278,10 +296,82 @@ namespace
         test_Generic<test_node_manager_t>(tresult, mngrToplogy);
     }
 
+    void test_AllocateNear(OP::utest::TestRuntime& tresult,
+        std::shared_ptr<test::ChangeHistoryFactory> mem_change_history)
+    {
+        struct TestPayload
+        {
+            TestPayload(int an1 = 0)
+                : n1(an1)
+            {
+            }
+            std::uint64_t v1 = 0;
+            int n1;
+        };
+
+        using test_node_manager_t = FixedSizeMemoryManager<TestPayload, test_nodes_count_c>;
+
+        std::shared_ptr<EventSourcingSegmentManager> tmngr1(
+            new EventSourcingSegmentManager(
+                BaseSegmentManager::create_new(
+                    node_file_name, OP::vtm::SegmentOptions().segment_size(0x110000)),
+                mem_change_history->create()
+            ));
+
+        SegmentTopology<test_node_manager_t> mngrToplogy(tmngr1);
+        auto& fmm = mngrToplogy.template slot<test_node_manager_t>();
+
+        //exhaust 0-segment and open the 1-st one
+        std::vector<FarAddress> zero_segment;
+        OP::vtm::TransactionGuard g1(mngrToplogy.segment_manager().begin_transaction());
+        for (unsigned i = 0; i < test_nodes_count_c; ++i)
+            zero_segment.push_back(fmm.allocate(static_cast<int>(i)));
+        auto first_segment = fmm.allocate();
+        g1.commit();
+        tresult.assert_that<equals>(2, mngrToplogy.segment_manager().available_segments(),
+            OP_CODE_DETAILS(<< "There must be one more segment"));
+        tresult.assert_that<equals>(1, first_segment.segment());
+
+        //put 2 entries of 0-segment ahead of the 1-st segment free block
+        OP::vtm::TransactionGuard g2(mngrToplogy.segment_manager().begin_transaction());
+        fmm.deallocate(zero_segment[3]);
+        fmm.deallocate(zero_segment[7]);
+        g2.commit();
+
+        OP::vtm::TransactionGuard g3(mngrToplogy.segment_manager().begin_transaction());
+        auto near = fmm.allocate_near(first_segment, 42);
+        g3.commit();
+        tresult.assert_that<equals>(1, near.segment(),
+            OP_CODE_DETAILS(<< "Entry must be taken from the segment of hint"));
+        tresult.assert_that<equals>(42, view<TestPayload>(mngrToplogy, near)->n1);
+        mngrToplogy._check_integrity(tresult.run_options().log_level() > ResultLevel::info);
+        auto usage = fmm.usage_info();
+        tresult.assert_that<equals>(test_nodes_count_c, usage.first);
+        tresult.assert_that<equals>(test_nodes_count_c, usage.second);
+
+        //hint at 0-segment picks head of the list
+        OP::vtm::TransactionGuard g4(mngrToplogy.segment_manager().begin_transaction());
+        auto same_segment = fmm.allocate_near(zero_segment[0], 57);
+        g4.commit();
+        tresult.assert_that<equals>(zero_segment[7], same_segment);
+        tresult.assert_that<equals>(57, view<TestPayload>(mngrToplogy, same_segment)->n1);
+
+        //nil hint works as plain allocate
+        OP::vtm::TransactionGuard g5(mngrToplogy.segment_manager().begin_transaction());
+        auto no_hint = fmm.allocate_near(FarAddress{}, 11);
+        g5.commit();
+        tresult.assert_that<equals>(zero_segment[3], no_hint);
+        mngrToplogy._check_integrity(tresult.run_options().log_level() > ResultLevel::info);
+        usage = fmm.usage_info();
+        tresult.assert_that<equals>(test_nodes_count_c + 2, usage.first);
+        tresult.assert_that<equals>(test_nodes_count_c - 2, usage.second);
+    }
+
     static auto& module_suite = OP::utest::default_test_suite("vtm.FixedSizeMemoryManager")
         .declare("general", test_NodeManager)
         .declare("multialloc", test_Multialloc)
         .declare("small-payload", test_NodeManagerSmallPayload)
+        .declare("allocate-near", test_AllocateNear)
         // define scenario parameter with InMemory implementation
         .with_fixture( "memory-only",
             test::memory_change_history_factory<test::InMemoryChangeHistoryFactory>)
@@ -26,10 +26,34 @@ void test_SegmentManager(OP::utest::TestRuntime& result)
         }
     );
 }
-              
+
+void test_Prefetch(OP::utest::TestRuntime& result)
+{
+    using namespace OP::vtm;
+    using namespace OP::utest;
+    auto manager = BaseSegmentManager::create_new("prefetch.test",
+        SegmentOptions().segment_size(0x110000));
+    manager->ensure_segment(0);
+    const FarAddress pos(0, manager->header_size());
+    {
+        auto wr = manager->writable_block(pos, sizeof(std::uint64_t));
+        *wr.at<std::uint64_t>(0) = 57;
+    }
+    //prefetch is only a hint, none of the following may throw or change content
+    manager->prefetch(pos, sizeof(std::uint64_t));
+    manager->prefetch(pos, manager->segment_size()); //range exceeds segment
+    manager->prefetch(FarAddress{}, 64); //nil
+    manager->prefetch(FarAddress(0, manager->segment_size() + 1), 64); //out of segment
+    manager->prefetch(FarAddress(100, 0), 64); //segment is not allocated
+    result.assert_that<equals>(1, manager->available_segments(), 
+        "prefetch must not allocate segments");
+    auto ro = manager->readonly_block(pos, sizeof(std::uint64_t));
+    result.assert_that<equals>(57, *ro.at<std::uint64_t>(0), OP_CODE_DETAILS());
+}
 
 //using std::placeholders;
 static auto& module_suite = OP::utest::default_test_suite("vtm.SegmentManager")
     .declare("HeapManagerSlot", test_SegmentManager)
+    .declare("prefetch", test_Prefetch)
 ;
 }//ns:
\ No newline at end of file